@@ -18,7 +18,7 @@
  * Default constructor.
  */
 configuration::configuration() {
- 
+    benchmarked = false;
 }
 
 /*
@@ -30,11 +30,13 @@ configuration::~configuration() {
 
 /*
  * Sets up the configuration screen.  Sets the tracker and 
- * parent.
+ * parent.  The gui edits a copy of the tracker's settings, 
+ * which is published back to the tracker after every change.
  */
 void configuration::setup(tracker* t, ofBaseApp* p) {
     _tracker = t;
     parent = p;
+    settings = _tracker->getSettings();
 
     header.loadImage(IMG_LOC_CONFIG_H);
     setupGUI();
@@ -45,12 +47,12 @@ void configuration::setup(tracker* t, ofBaseApp* p) {
  * and manual mode for easy drawing/dealing with input.
  */
 void configuration::setupGUI() {
-    thresholdSlider = guiSlider("Threshold", _tracker->getThreshold(), ofPoint(20, 360), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
+    thresholdSlider = guiSlider("Threshold", &settings.threshold, ofPoint(20, 360), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
     lightGUI.add(&thresholdSlider);
 
-    hueSlider = guiSlider("Hue Range", _tracker->getHueRange(), ofPoint(20, 330), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
-    saturationSlider = guiSlider("Saturation Range", _tracker->getSaturationRange(), ofPoint(20, 360), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
-    valueSlider = guiSlider("Value Range", _tracker->getValueRange(), ofPoint(20, 390), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
+    hueSlider = guiSlider("Hue Range", &settings.hueRange, ofPoint(20, 330), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
+    saturationSlider = guiSlider("Saturation Range", &settings.saturationRange, ofPoint(20, 360), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
+    valueSlider = guiSlider("Value Range", &settings.valueRange, ofPoint(20, 390), STD_SLIDER_W, STD_SLIDER_H, 0, 255);
     manualGUI.add(&hueSlider);
     manualGUI.add(&saturationSlider);
     manualGUI.add(&valueSlider);
@@ -68,11 +70,15 @@ void configuration::setupGUI() {
     lightOp.setLable(true);
     manualOp = guiOption("Manual", ofPoint(140, togY), STD_TOG_SIZE, STD_TOG_SIZE, MANUAL);
     manualOp.setLable(true);
-    if (_tracker->mode == LIGHT) lightOp.setActive(true);
-    else { manualOp.setActive(true);}
-    trackOptions.setValue(&_tracker->mode);
+    camShiftOp = guiOption("Adaptive", ofPoint(260, togY), STD_TOG_SIZE, STD_TOG_SIZE, CAMSHIFT);
+    camShiftOp.setLable(true);
+    if (settings.mode == LIGHT) lightOp.setActive(true);
+    else if (settings.mode == MANUAL) manualOp.setActive(true);
+    else { camShiftOp.setActive(true);}
+    trackOptions.setValue(&settings.mode);
     trackOptions.add(&lightOp);
     trackOptions.add(&manualOp);
+    trackOptions.add(&camShiftOp);
     GUI.add(&trackOptions);
 
     helpWindow = guiHelpWindow(IMG_LOC_HELP_CONFIG);
@@ -80,38 +86,103 @@ void configuration::setupGUI() {
 }
 
 /*
- * Updates the configuration screen. 
+ * Updates the configuration screen.  Picks up the tuned 
+ * settings once the auto tuner is done.
  */
 void configuration::update() {
+    if (tuner.update()) {
+        settings = _tracker->getSettings();
+        trackOptions.sync();
+    }
+}
+
+/*
+ * Returns how much tracking the configuration screen needs. 
+ * It shows everything the tracker sees.
+ */
+int configuration::getTrackingDemand() {
+    return TRACK_DEBUG;
 }
 
 /*
  * Draws the configuration screen.  Depending on what mode it is 
- * in, it draws a different top video feed and sliders. 
+ * in, it draws a different top video feed and sliders.  Without 
+ * a source there are no feeds to draw. 
  */
 void configuration::draw() {
     ofPushStyle();
     header.draw(ofGetWidth()/2-header.getWidth()/2, 0);
 
-    if (_tracker->mode == LIGHT) _tracker->getGrayscaleData()->draw(20, 50);
-    else {_tracker->getColorData()->draw(20, 50);}
-    _tracker->getContours()->draw(20, 50);
+    ofTexture* video = settings.mode == LIGHT ? _tracker->getGrayscaleData() : _tracker->getColorData();
+    if (video != 0) video->draw(20, 50);
+    const vector<blob>& blobs = _tracker->getBlobs();
+    ofNoFill();
+    for (int i = 0; i < blobs.size(); i++) {
+        ofSetColor(255, 0, 255);
+        ofRect(20 + blobs[i].left, 50 + blobs[i].top, blobs[i].right - blobs[i].left + 1, blobs[i].bottom - blobs[i].top + 1);
+        ofSetColor(255, 0, 0);
+        ofCircle(20 + blobs[i].x, 50 + blobs[i].y, 2);
+    }
+    ofFill();
+    if (settings.mode == CAMSHIFT && _tracker->hasTarget()) {
+        ofRectangle window = _tracker->getSearchWindow();
+        ofNoFill();
+        ofSetColor(255, 255, 0);
+        ofRect(20 + window.x, 50 + window.y, window.width, window.height);
+        ofFill();
+    }
     ofSetColor(255, 255, 255);
-    _tracker->getThresholdData()->draw(20, 420);
-
-    if (_tracker->mode == LIGHT) lightGUI.draw();
-    else {manualGUI.draw();}
+    ofTexture* threshold = _tracker->getThresholdData();
+    if (settings.mode != CAMSHIFT && threshold != 0) threshold->draw(20, 420);
+
+    if (settings.mode == LIGHT) lightGUI.draw();
+    else if (settings.mode == MANUAL) manualGUI.draw();
+
+    if (benchmarked) {
+        char reportStr[1024];
+        sprintf(reportStr, "light: generic %.0fus specialized %.0fus\ncolor: generic %.0fus specialized %.0fus\nresults %s",
+                benchmark.genericLight, benchmark.specializedLight, benchmark.genericColor, benchmark.specializedColor,
+                benchmark.agree ? "match" : "DIFFER");
+        ofDrawBitmapString(reportStr, 360, 440);
+        sprintf(reportStr, "serial: %.0f fps, %.1fms latency\nstaged: %.0f fps, %.1fms latency",
+                stagedResults.serialFps, stagedResults.serialLatency, stagedResults.stagedFps, stagedResults.stagedLatency);
+        ofDrawBitmapString(reportStr, 360, 500);
+    }
+    if (tuner.isRunning()) {
+        ofDrawBitmapString("tuning: " + ofToString((int)(tuner.getProgress() * 100)) + "%", 360, 420);
+    }
+    else if (tuner.getError() >= 0) {
+        ofDrawBitmapString("tuned: off by " + ofToString(tuner.getError()) + "px", 360, 420);
+    }
+    ofDrawBitmapString("late latch: " + ofToString(_tracker->getLatchSaving(), 1) + "ms newer, " +
+                       ofToString(_tracker->getLatchLead(), 1) + "ms extrapolated", 360, 560);
     GUI.draw();
     ofPopStyle();
 }
 
+/*
+ * Handles key presses.  'b' benchmarks the tracker pipelines 
+ * and the staged pipeline on the current frame.  't' tunes the tracker on the recording 
+ * in settings/tuning.xml.
+ */
+void configuration::keyPressed(int key) {
+    if (key == 'b') {
+        _tracker->benchmark(&benchmark, &stagedResults);
+        benchmarked = true;
+    }
+    if (key == 't') {
+        tuner.start(_tracker);
+    }
+}
+
 /*
  * Handles when the mouse is dragged.  Checks the sliders, 
  * depending on the current mode. 
  */
 void configuration::mouseDragged(int x, int y, int button) {
-    if (_tracker->mode == LIGHT) lightGUI.mouseDragged(x, y);
-    else {manualGUI.mouseDragged(x, y);}
+    if (settings.mode == LIGHT) lightGUI.mouseDragged(x, y);
+    else if (settings.mode == MANUAL) manualGUI.mouseDragged(x, y);
+    publishSettings();
 }
 
 /*
@@ -119,8 +190,9 @@ void configuration::mouseDragged(int x, int y, int button) {
  */
 void configuration::mousePressed(int x, int y, int button) {
     GUI.mousePressed(x, y);
-    if (_tracker->mode == LIGHT) lightGUI.mousePressed(x, y);
-    else {manualGUI.mousePressed(x, y);}
+    if (settings.mode == LIGHT) lightGUI.mousePressed(x, y);
+    else if (settings.mode == MANUAL) manualGUI.mousePressed(x, y);
+    publishSettings();
 
     if (backBut.checkHit(x, y)) {
         ((screenManager*)parent)->setMode(TITLE);
@@ -132,7 +204,20 @@ void configuration::mousePressed(int x, int y, int button) {
         helpWindow.show();
     }
     //MAGIC NUMBERS!!
-    if (_tracker->mode == MANUAL && x >= 20 && x <= 340 && y >= 50 && y <= 290) {    
+    if (settings.mode == MANUAL && x >= 20 && x <= 340 && y >= 50 && y <= 290) {    
         _tracker->setHueSatValByPixel((y-50) * 320 + (x-20));
+        settings = _tracker->getSettings();
     }
+    if (settings.mode == CAMSHIFT && x >= 20 && x <= 340 && y >= 50 && y <= 290) {
+        _tracker->setHistogramByPixel((y-50) * 320 + (x-20));
+        settings = _tracker->getSettings();
+    }
+}
+
+/*
+ * Hands the edited settings to the tracker.  The tracker only 
+ * moves its version if something actually changed.
+ */
+void configuration::publishSettings() {
+    _tracker->setSettings(settings);
 }
@@ -19,6 +19,7 @@
 #include "tracker.h"
 #include "gui.h"
 #include "XMLUtil.h"
+#include "autoTuner.h"
 
 class configuration : public ofBaseApp {
 
@@ -30,16 +31,24 @@ class configuration : public ofBaseApp {
         void setup(tracker* t, ofBaseApp* p);
         void update();
         void draw();
+        int getTrackingDemand();
 
+        void keyPressed(int key);
         void mouseDragged(int x, int y, int button);
         void mousePressed(int x, int y, int button);
 
     private:
 
         void setupGUI();
+        void publishSettings();
 
         ofBaseApp* parent;
         tracker* _tracker;
+        trackerSettings settings;
+        pipelineBenchmark benchmark;
+        stagedBenchmark stagedResults;
+        bool benchmarked;
+        autoTuner tuner;
         XMLUtil xml;      
   
         ofImage header;
@@ -47,7 +56,7 @@ class configuration : public ofBaseApp {
         gui GUI, lightGUI, manualGUI;
         guiSlider thresholdSlider, hueSlider, saturationSlider, valueSlider;
         guiButton backBut, saveBut, helpBut;
-        guiOption lightOp, manualOp;
+        guiOption lightOp, manualOp, camShiftOp;
         guiOptionGroup trackOptions;
         guiHelpWindow helpWindow;
 };
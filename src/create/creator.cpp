@@ -89,6 +89,14 @@ void creator::update() {
 
 }
 
+/*
+ * Returns how much tracking the creator needs.  Courses are
+ * made with the mouse.
+ */
+int creator::getTrackingDemand() {
+    return TRACK_NONE;
+}
+
 
 /**
  * Draws the course being created, GUI, and temporary point being drawn (if any).
@@ -305,19 +313,12 @@ bool creator::mousePressedGUI(int x, int y) {
 }
 
 /**
- * Finds a candidate node.  Checks to see if the given mouse 
- * position is close enough to any node in the course.
+ * Finds a candidate node.  Asks the course for the closest node 
+ * to the given mouse position, if any is close enough.
  */
 void creator::findCandidate(int x, int y) {
-    hasCandidate = false;
-    candidate = 0;
-    
-    for (list<ofPoint>::iterator it = currentCourse.nodes.begin(); it != currentCourse.nodes.end(); it++) {    
-        if (selected != &*it && abs(it->x - x) < NODE_SIZE && abs(it->y - y) < NODE_SIZE) {
-            candidate = &*it;
-            hasCandidate = true;
-        }
-    }
+    candidate = currentCourse.getNearestNode(x, y, NODE_SIZE, selected);
+    hasCandidate = candidate != 0;
     //Only check the start and finish nodes when in MOVING mode.
     if (mode == MOVING && selected == 0) {
         if (abs(currentCourse.start.x - x) < IMP_NODE_SIZE && abs(currentCourse.start.y - y)< IMP_NODE_SIZE) {
@@ -334,33 +335,24 @@ void creator::findCandidate(int x, int y) {
 /**
  * Finds poits on edges that are close enough to the given 
  * mouse position.  If one is found, that intersection point
- * is stored and a pointer to that edge is returned.
+ * is stored and a pointer to that edge is returned.  Only the 
+ * edges near the mouse are checked.  The point is the closest 
+ * one on the edge, so edges of any direction work the same.
  */
 edge* creator::findIntersectingEdge(int x, int y) {
     hasIntersect = false;
     intersect = ofPoint(0);
     if (!hasCandidate) {
-        double yInt = 0;
-        for (list<edge>::iterator it = currentCourse.edges.begin(); it != currentCourse.edges.end(); it++) {
-            if (it->withinBounds(x, y, NODE_SIZE) && !containsEdge(currentCourse.getAssocEdges(selected), &*it)) {
-                //Have to handle horizontal and vertical lines as separate
-                //cases because of slope issues.
-                if (it->xAxis) {
-                    intersect.x = x;
-                    intersect.y = it->p1->y;
-                }
-                else if (it->yAxis) {
-                    intersect.x = it->p1->x;
-                    intersect.y = y;
-                }
-                else {
-                     yInt = y + (it->slope * x);
-                    intersect.x = (yInt - it->yIntercept) / (2 * it->slope);
-                    intersect.y = (-1 * it->slope * intersect.x) + yInt;
-                }
-                if (sqrt(pow(x - intersect.x, 2) + pow(y - intersect.y, 2)) < NODE_SIZE)  {
-                    hasIntersect = true;    
-                    return &*it;
+        ofPoint mouse(x, y);
+        vector<edge*> assoc = currentCourse.getAssocEdges(selected);
+        currentCourse.getEdgesNear(x, y, NODE_SIZE, nearbyEdges);
+        for (int i = 0; i < nearbyEdges.size(); i++) {
+            edge* it = nearbyEdges[i];
+            if (!containsEdge(assoc, it)) {
+                if (it->distanceSquared(mouse) < NODE_SIZE * NODE_SIZE) {
+                    intersect = it->closestPoint(mouse);
+                    hasIntersect = true;
+                    return it;
                 }
             }
         }
@@ -373,7 +365,7 @@ edge* creator::findIntersectingEdge(int x, int y) {
  * given edge. 
  * Should probably be moved to a different class.
  */
-bool creator::containsEdge(vector<edge*> edges, edge* e) {
+bool creator::containsEdge(const vector<edge*>& edges, edge* e) {
     for (int i = 0; i < edges.size(); i++) {
         if (edges[i] == e) return true;
     }
@@ -32,6 +32,7 @@ class creator : public ofBaseApp {
         void setup(tracker* t, ofBaseApp* p);
         void update();
         void draw();
+        int getTrackingDemand();
         void reset();
 
         void keyPressed(int key);
@@ -46,7 +47,7 @@ class creator : public ofBaseApp {
         void setupGUI();
         void findCandidate(int x, int y);
         edge* findIntersectingEdge(int x, int y);
-        bool containsEdge(vector<edge*> edges, edge* e);        
+        bool containsEdge(const vector<edge*>& edges, edge* e);        
 
         ofBaseApp* parent;
         tracker* _tracker;
@@ -57,6 +58,7 @@ class creator : public ofBaseApp {
 
         course currentCourse;
         ofPoint* candidate;
+        vector<edge*> nearbyEdges;
         ofPoint* selected;
         ofPoint* base;
         ofPoint temp, intersect;
@@ -11,6 +11,7 @@
  */
 
 #include "flashtrack.h"
+#include "XMLUtil.h"
 
 /*
  * Default constructor.
@@ -22,7 +23,12 @@ flashtrack::flashtrack() {
  * Sets up the flashtrack object.
  */
 void flashtrack::setup() {
+    XMLUtil xml;
+    xml.loadSources(&_tracker);
     _tracker.setup(320, 240, ofGetWidth(), ofGetHeight());
+    xml.loadPublishing(&_tracker);
+    xml.loadRecording(&_tracker);
+    xml.loadLatching(&_tracker);
     manager.setup(&_tracker);
     ofBackground(0, 0, 0);
     bgMusic.loadSound("sounds/Aurora.mp3");
@@ -31,9 +37,11 @@ void flashtrack::setup() {
 }
 
 /*
- * Updates the tracker and screen manager.
+ * Updates the tracker and screen manager.  The tracker only 
+ * does as much as the screen manager needs.
  */
 void flashtrack::update() {
+    _tracker.setDemand(manager.getTrackingDemand());
     _tracker.update();
     manager.update();
 }
@@ -42,17 +50,42 @@ void flashtrack::update() {
  * Draws the tracker and the screen manager.
  */
 void flashtrack::draw() {
+    _tracker.latch();
     _tracker.draw();
     manager.draw();
 }
 
 /*
- * Handles key presses.  Sends input to screen manager.
+ * Handles key presses.  F11 plays the game simulation, F12 dumps 
+ * the tracker's flight recorders, and everything else is sent to 
+ * the screen manager.
  */
 void flashtrack::keyPressed(int key) {
+    if (key == OF_KEY_F11) {
+        simulate();
+        return;
+    }
+    if (key == OF_KEY_F12) {
+        _tracker.dumpRecording();
+        return;
+    }
     manager.keyPressed(key);
 }
 
+/*
+ * Plays every course's default cases, and the ones listed in 
+ * settings/simulation.xml, through the game rules.  The report 
+ * is printed and saved in the simulation folder.
+ */
+void flashtrack::simulate() {
+    gameSimulator simulator;
+    XMLUtil xml;
+    simulator.addCourses("courses/");
+    simulator.addCourses("courses/user");
+    xml.loadSimulation(&simulator);
+    simulator.run();
+}
+
 /*
  * Handles key releases.  Sends input to screen manager.
  */
@@ -36,6 +36,8 @@ class flashtrack : public ofBaseApp {
     
     private:
 
+        void simulate();
+
         screenManager manager;
         tracker _tracker;
 
@@ -0,0 +1,179 @@
+/*
+ * collisionField.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A rasterized copy of a course's edges used to 
+ * rule out collisions during a game.  Every edge is drawn a 
+ * little thicker than EDGE_WIDTH into a grid with one cell per 
+ * screen pixel when the course loads.  Checking a piece of the 
+ * trail is then a walk along its pixels, no matter how many 
+ * edges the course has, and only pieces that hit the field need 
+ * exact tests.  Courses too big for a field of FIELD_MAX_CELLS 
+ * can have a field of just the region around the view instead, 
+ * built again as the view moves.
+ *
+ */
+
+#include "collisionField.h"
+#include "math.h"
+
+/*
+ * Default constructor.  An empty field blocks nothing.
+ */
+collisionField::collisionField() {
+    clear();
+}
+
+/*
+ * Rasterizes the edges of the given course.  The field only 
+ * covers the bounds of the edges, so pixels outside of it are 
+ * never blocked.  Returns false, leaving the field empty, if 
+ * the course is too big.
+ */
+bool collisionField::build(course* c) {
+    clear();
+    if (c->edges.empty()) return true;
+
+    float minX = c->edges.front().p1->x, maxX = minX;
+    float minY = c->edges.front().p1->y, maxY = minY;
+    for (list<edge>::iterator it = c->edges.begin(); it != c->edges.end(); it++) {
+        minX = min(minX, min(it->p1->x, it->p2->x));
+        maxX = max(maxX, max(it->p1->x, it->p2->x));
+        minY = min(minY, min(it->p1->y, it->p2->y));
+        maxY = max(maxY, max(it->p1->y, it->p2->y));
+    }
+    left = (int)floor(minX) - EDGE_WIDTH - FIELD_MARGIN;
+    top = (int)floor(minY) - EDGE_WIDTH - FIELD_MARGIN;
+    width = (int)ceil(maxX) + EDGE_WIDTH + FIELD_MARGIN - left + 1;
+    height = (int)ceil(maxY) + EDGE_WIDTH + FIELD_MARGIN - top + 1;
+    if ((double)width * height > FIELD_MAX_CELLS) {
+        clear();
+        return false;
+    }
+    cells.assign(width * height, 0);
+
+    for (list<edge>::iterator it = c->edges.begin(); it != c->edges.end(); it++) {
+        stampEdge(&*it);
+    }
+    return true;
+}
+
+/*
+ * Rasterizes the edges of the given course that reach into the 
+ * given region.  Pixels outside of the region are always blocked, 
+ * since the field doesn't know about them, so lines through them 
+ * get exact tests.  Returns false, leaving the field empty, if 
+ * the region is too big.
+ */
+bool collisionField::build(course* c, ofRectangle region) {
+    clear();
+    left = (int)floor(region.x);
+    top = (int)floor(region.y);
+    width = (int)ceil(region.x + region.width) - left;
+    height = (int)ceil(region.y + region.height) - top;
+    if ((double)width * height > FIELD_MAX_CELLS) {
+        clear();
+        return false;
+    }
+    cells.assign(width * height, 0);
+    partial = true;
+
+    float reach = EDGE_WIDTH / 2.0f + FIELD_MARGIN;
+    c->getEdgesIn(ofRectangle(left - reach, top - reach, width + 2 * reach, height + 2 * reach), regionEdges);
+    for (int i = 0; i < regionEdges.size(); i++) {
+        stampEdge(regionEdges[i]);
+    }
+    return true;
+}
+
+/*
+ * Empties the field.
+ */
+void collisionField::clear() {
+    left = top = width = height = 0;
+    partial = false;
+    cells.clear();
+}
+
+/*
+ * Returns if this is a field of just a region, and it has all of 
+ * the given region.
+ */
+bool collisionField::covers(ofRectangle region) {
+    return partial && region.x >= left && region.y >= top &&
+           region.x + region.width <= left + width && region.y + region.height <= top + height;
+}
+
+/*
+ * Returns if the given pixel is covered by an edge, or is close 
+ * enough that a point in it might be.  Outside of a field of 
+ * just a region, every pixel might be.
+ */
+bool collisionField::isBlocked(int x, int y) {
+    x -= left;
+    y -= top;
+    if (x < 0 || y < 0 || x >= width || y >= height) return partial;
+    return cells[y * width + x] != 0;
+}
+
+/*
+ * Returns if any pixel on the line from a to b is covered by 
+ * an edge.  Steps one pixel at a time along the longer axis. 
+ * The margin around the edges makes up for rounding to pixels, 
+ * so a line that comes within half of EDGE_WIDTH of an edge is 
+ * never missed.
+ */
+bool collisionField::crosses(ofPoint a, ofPoint b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    int steps = (int)ceil(max(fabs(dx), fabs(dy)));
+    if (steps == 0) return isBlocked((int)floor(a.x + 0.5f), (int)floor(a.y + 0.5f));
+    for (int i = 0; i <= steps; i++) {
+        float t = (float)i / steps;
+        if (isBlocked((int)floor(a.x + dx * t + 0.5f), (int)floor(a.y + dy * t + 0.5f))) return true;
+    }
+    return false;
+}
+
+/*
+ * Marks every pixel within half of EDGE_WIDTH, plus the margin, 
+ * of the edge.  Each row only tests the pixels around where the 
+ * edge passes through it, instead of the edge's whole bounding box.
+ */
+void collisionField::stampEdge(edge* e) {
+    float radius = EDGE_WIDTH / 2.0f + FIELD_MARGIN;
+    float ax = e->p1->x - left, ay = e->p1->y - top;
+    float bx = e->p2->x - left, by = e->p2->y - top;
+    float dx = bx - ax, dy = by - ay;
+    float lengthSq = dx * dx + dy * dy;
+
+    int firstRow = max(0, (int)floor(min(ay, by) - radius));
+    int lastRow = min(height - 1, (int)ceil(max(ay, by) + radius));
+    for (int y = firstRow; y <= lastRow; y++) {
+        //the part of the edge that comes within radius of this row
+        float t0 = 0, t1 = 1;
+        if (dy != 0) {
+            t0 = (y - radius - ay) / dy;
+            t1 = (y + radius - ay) / dy;
+            if (t0 > t1) swap(t0, t1);
+            t0 = max(t0, 0.0f);
+            t1 = min(t1, 1.0f);
+            if (t0 > t1) continue;
+        }
+        int firstCol = max(0, (int)floor(min(ax + dx * t0, ax + dx * t1) - radius));
+        int lastCol = min(width - 1, (int)ceil(max(ax + dx * t0, ax + dx * t1) + radius));
+
+        unsigned char* row = &cells[y * width];
+        for (int x = firstCol; x <= lastCol; x++) {
+            if (row[x]) continue;
+            float t = lengthSq > 0 ? ((x - ax) * dx + (y - ay) * dy) / lengthSq : 0;
+            t = max(0.0f, min(1.0f, t));
+            float px = ax + dx * t - x;
+            float py = ay + dy * t - y;
+            if (px * px + py * py <= radius * radius) row[x] = 1;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * collisionField.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A rasterized copy of a course's edges used to 
+ * rule out collisions during a game.  Every edge is drawn a 
+ * little thicker than EDGE_WIDTH into a grid with one cell per 
+ * screen pixel when the course loads.  Checking a piece of the 
+ * trail is then a walk along its pixels, no matter how many 
+ * edges the course has, and only pieces that hit the field need 
+ * exact tests.  Courses too big for a field of FIELD_MAX_CELLS 
+ * can have a field of just the region around the view instead, 
+ * built again as the view moves.
+ *
+ */
+
+#ifndef _COLLISION_FIELD_H
+#define _COLLISION_FIELD_H
+
+#include "ofTypes.h"
+#include "course.h"
+
+#define FIELD_MAX_CELLS (4096 * 4096)
+#define FIELD_MARGIN 2
+
+class collisionField {
+
+    public:
+
+        collisionField();
+
+        bool build(course* c);
+        bool build(course* c, ofRectangle region);
+        void clear();
+
+        bool covers(ofRectangle region);
+        bool isBlocked(int x, int y);
+        bool crosses(ofPoint a, ofPoint b);
+
+    private:
+
+        void stampEdge(edge* e);
+
+        int left, top, width, height;
+        bool partial;
+        vector<unsigned char> cells;
+        vector<edge*> regionEdges;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * courseCamera.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Decides which part of a course is on the screen 
+ * during a game.  The tracker only knows screen positions, so the 
+ * camera scrolls when the player draws near the sides of the 
+ * screen, faster the closer they get, up to CAMERA_SPEED pixels a 
+ * second.  The view never goes further than CAMERA_PADDING past 
+ * the course, so a course that fits on the screen never scrolls.
+ *
+ */
+
+#include "courseCamera.h"
+
+/*
+ * Default constructor.  Looks at the top left of the plane.
+ */
+courseCamera::courseCamera() {
+    view = ofPoint(0, 0);
+}
+
+/*
+ * Sets the course to look at, and looks at its start.
+ */
+void courseCamera::setCourse(course* c) {
+    bounds = c->getBounds();
+    center(c->start);
+}
+
+/*
+ * Moves the view so the given course position is in the middle 
+ * of the screen, or as close as the course allows.
+ */
+void courseCamera::center(ofPoint position) {
+    view = ofPoint(position.x - ofGetWidth() / 2, position.y - ofGetHeight() / 2);
+    clamp();
+}
+
+/*
+ * Scrolls towards where the player is on the screen, if they are 
+ * within CAMERA_BORDER of a side, for the given number of seconds.
+ */
+void courseCamera::follow(ofPoint screenPosition, double seconds) {
+    float borderX = ofGetWidth() * CAMERA_BORDER;
+    float borderY = ofGetHeight() * CAMERA_BORDER;
+    float dx = 0, dy = 0;
+    if (screenPosition.x < borderX) dx = (screenPosition.x - borderX) / borderX;
+    else if (screenPosition.x > ofGetWidth() - borderX) dx = (screenPosition.x - (ofGetWidth() - borderX)) / borderX;
+    if (screenPosition.y < borderY) dy = (screenPosition.y - borderY) / borderY;
+    else if (screenPosition.y > ofGetHeight() - borderY) dy = (screenPosition.y - (ofGetHeight() - borderY)) / borderY;
+
+    view.x += max(-1.0f, min(1.0f, dx)) * CAMERA_SPEED * seconds;
+    view.y += max(-1.0f, min(1.0f, dy)) * CAMERA_SPEED * seconds;
+    clamp();
+}
+
+/*
+ * Scrolls towards having the given course position in the middle 
+ * of the screen, at CAMERA_SPEED, for the given number of seconds.
+ */
+void courseCamera::approach(ofPoint position, double seconds) {
+    ofPoint target = view;
+    center(position);
+    swap(target, view);
+    ofPoint offset = target - view;
+    float distance = sqrt(offset.x * offset.x + offset.y * offset.y);
+    float reach = CAMERA_SPEED * seconds;
+    if (distance <= reach) view = target;
+    else {view += offset * (reach / distance);}
+}
+
+/*
+ * Returns the course position at the top left of the screen.
+ */
+ofPoint courseCamera::getView() {
+    return view;
+}
+
+/*
+ * Returns the part of the course that is on the screen.
+ */
+ofRectangle courseCamera::getViewBounds() {
+    return ofRectangle(view.x, view.y, ofGetWidth(), ofGetHeight());
+}
+
+/*
+ * Returns the course position under the given screen position.
+ */
+ofPoint courseCamera::toCourse(ofPoint screenPosition) {
+    return ofPoint(screenPosition.x + view.x, screenPosition.y + view.y);
+}
+
+/*
+ * Keeps the view within CAMERA_PADDING of the course.  Along an 
+ * axis the course fits on the screen, it is made to be seen from 
+ * the top left of the plane, so the view stays there.
+ */
+void courseCamera::clamp() {
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    if (bounds.x < 0 || bounds.x + bounds.width > ofGetWidth()) {
+        minX = min(0.0f, bounds.x - CAMERA_PADDING);
+        maxX = max(0.0f, bounds.x + bounds.width + CAMERA_PADDING - ofGetWidth());
+    }
+    if (bounds.y < 0 || bounds.y + bounds.height > ofGetHeight()) {
+        minY = min(0.0f, bounds.y - CAMERA_PADDING);
+        maxY = max(0.0f, bounds.y + bounds.height + CAMERA_PADDING - ofGetHeight());
+    }
+    view.x = max(minX, min(maxX, view.x));
+    view.y = max(minY, min(maxY, view.y));
+}
@@ -0,0 +1,51 @@
+/*
+ * courseCamera.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Decides which part of a course is on the screen 
+ * during a game.  The tracker only knows screen positions, so the 
+ * camera scrolls when the player draws near the sides of the 
+ * screen, faster the closer they get, up to CAMERA_SPEED pixels a 
+ * second.  The view never goes further than CAMERA_PADDING past 
+ * the course, so a course that fits on the screen never scrolls.
+ *
+ */
+
+#ifndef _COURSE_CAMERA_H
+#define _COURSE_CAMERA_H
+
+#include "ofMain.h"
+#include "ofTypes.h"
+#include "course.h"
+
+#define CAMERA_BORDER 0.2f
+#define CAMERA_SPEED 900
+#define CAMERA_PADDING 100
+
+class courseCamera {
+
+    public:
+
+        courseCamera();
+
+        void setCourse(course* c);
+        void center(ofPoint position);
+        void follow(ofPoint screenPosition, double seconds);
+        void approach(ofPoint position, double seconds);
+
+        ofPoint getView();
+        ofRectangle getViewBounds();
+        ofPoint toCourse(ofPoint screenPosition);
+
+    private:
+
+        void clamp();
+
+        ofRectangle bounds;
+        ofPoint view;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * courseLoader.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Loads a course on a background thread, so the 
+ * next course of a continuous game is ready before it is needed. 
+ * The course file is parsed, the course indexed, and its 
+ * collision field built off the main thread.  The course and 
+ * field being loaded must not be touched until the loader is done.
+ *
+ */
+
+#include "courseLoader.h"
+#include "XMLUtil.h"
+
+/*
+ * Default constructor.  Nothing loaded.
+ */
+courseLoader::courseLoader() {
+    target = 0;
+    field = 0;
+    loaded = false;
+    useField = false;
+    finished = false;
+}
+
+/*
+ * Destructor.  Waits for a load in progress.
+ */
+courseLoader::~courseLoader() {
+    wait();
+}
+
+/*
+ * Starts loading the course at the given path into c, and building 
+ * its collision field in f.  Waits for the last load first.
+ */
+void courseLoader::load(string _path, course* c, collisionField* f) {
+    wait();
+    path = _path;
+    target = c;
+    field = f;
+    loaded = false;
+    useField = false;
+    finished = false;
+    startThread(false, false);
+}
+
+/*
+ * Blocks until the load in progress, if any, is done.  The load 
+ * doesn't stop early; the thread is only joined.
+ */
+void courseLoader::wait() {
+    if (target != 0) waitForThread(true);
+}
+
+/*
+ * Waits for the load in progress and forgets it.
+ */
+void courseLoader::clear() {
+    wait();
+    path = "";
+    target = 0;
+    field = 0;
+    loaded = false;
+    finished = false;
+}
+
+/*
+ * Returns if a load was started and has finished.
+ */
+bool courseLoader::isDone() {
+    lock();
+    bool done = target != 0 && finished;
+    unlock();
+    return done;
+}
+
+/*
+ * Returns the path of the course being loaded.
+ */
+string courseLoader::getPath() {
+    return path;
+}
+
+/*
+ * Returns if the course loaded.  Only valid once the loader is done.
+ */
+bool courseLoader::getLoaded() {
+    return loaded;
+}
+
+/*
+ * Returns if the course got a collision field.  Only valid once the 
+ * loader is done.
+ */
+bool courseLoader::getUseField() {
+    return useField;
+}
+
+/*
+ * Loads the course and builds its collision field.
+ */
+void courseLoader::threadedFunction() {
+    XMLUtil xml;
+    bool _loaded = xml.loadCourse(path, target);
+    bool _useField = field->build(target);
+    lock();
+    loaded = _loaded;
+    useField = _useField;
+    finished = true;
+    unlock();
+}
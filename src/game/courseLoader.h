@@ -0,0 +1,49 @@
+/*
+ * courseLoader.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Loads a course on a background thread, so the 
+ * next course of a continuous game is ready before it is needed. 
+ * The course file is parsed, the course indexed, and its 
+ * collision field built off the main thread.  The course and 
+ * field being loaded must not be touched until the loader is done.
+ *
+ */
+
+#ifndef _COURSE_LOADER_H
+#define _COURSE_LOADER_H
+
+#include "ofMain.h"
+#include "course.h"
+#include "collisionField.h"
+
+class courseLoader : public ofThread {
+
+    public:
+
+        courseLoader();
+        virtual ~courseLoader();
+
+        void load(string path, course* c, collisionField* f);
+        void wait();
+        void clear();
+        bool isDone();
+
+        string getPath();
+        bool getLoaded();
+        bool getUseField();
+
+        void threadedFunction();
+
+    private:
+
+        string path;
+        course* target;
+        collisionField* field;
+        bool loaded, useField, finished;
+};
+
+#endif
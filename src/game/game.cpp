@@ -7,7 +7,15 @@
  *
  * Description:  Handles the gameplay of the application.
  * Draws the current course and tests the input to see 
- * if the course has been completed.
+ * if the course has been completed.  The game rules run at a 
+ * fixed GAME_RATE steps per second, no matter how fast frames 
+ * are drawn.  In a continuous game, the next course is loaded 
+ * in the background while the current one is played.  Courses 
+ * bigger than the screen scroll with the player.  Up to 
+ * MAX_PLAYERS can race on the same course, each following their 
+ * own target; the first to reach the finish wins.  Races are seen 
+ * from the start and don't scroll, so they are best run on courses 
+ * that fit on the screen.
  *
  */
 
@@ -16,6 +24,13 @@
 #include "math.h"
 #include "XMLUtil.h"
 
+/*
+ * The color each player's line is tinted with.
+ */
+static const int playerColors[MAX_PLAYERS][3] = {
+    {255, 255, 255}, {255, 120, 120}, {120, 255, 120}, {255, 230, 100}
+};
+
 /*
  * Default constructor.
  */
@@ -23,18 +38,33 @@ game::game() {
 }
 
 /*
- * Sets up the game application.  Sets tracker and parent.
+ * Sets up the game application.  Sets tracker and parent, and 
+ * how many players race from settings/race.xml.
  */
 void game::setup(tracker* t, ofBaseApp* p) {
     _tracker = t;
     parent = p;
-    drawing = false;
     continuous = true;
     transition = false;
+    hasSample = false;
+    sampleTime = lastSampleTime = 0;
+    gameCourse = &courses[0];
+    gameField = &fields[0];
+    prefetchPending = false;
+    nextPrepared = false;
+    wholeField = false;
+    winner = -1;
     fader.setFadeSeconds(1.3f);
     fader.setUnitColor(0.0f, 0.0f, 0.0f);
     edgeImg.loadImage("images/edge_blue.png");
     nodeImg.loadImage("images/node_blue.png");
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        players[i].getTrail()->setImage(&edgeImg);
+        players[i].getTrail()->setColor(playerColors[i][0], playerColors[i][1], playerColors[i][2]);
+    }
+    setNumPlayers(1);
+    XMLUtil xml;
+    xml.loadRace(this);
 
     completeSound.loadSound("sounds/ding.aif");
     completeSound.setVolume(0.25f);
@@ -51,48 +81,51 @@ void game::setupGUI() {
 }
 
 /*
- * Updates the game.  Checks for win/loss conditions.  Checks to see if the 
- * player has started drawing.  If so, adds the tracker's position to the 
- * current line.
+ * Updates the game.  If the tracker measured the players again, takes 
+ * their new positions, and runs every step of the game rules that is 
+ * due up to when they were measured.  The game's clock is the tracker's: 
+ * each step gets the positions at its own time, in between the last two 
+ * measured ones, so how often frames are drawn doesn't change where 
+ * the steps are.  If the game fell too far behind, like after a pause, 
+ * the missed steps are skipped instead of caught up.
  */
 void game::update() {
-    if (drawing) {
-        previousPoints.push_back(ofPoint(_tracker->getX(), _tracker->getY()));
-        if (!outOfBounds()) {    
-            if (previousPoints.size() > 1) {
-                list<ofPoint>::iterator it = previousPoints.end();
-                it--;
-                ofPoint* temp1 = &*it;
-                it--;
-                ofPoint* temp2 = &*it;
-                currentLine.push_back(edge(temp1, temp2));
-            }
-            if (courseComplete(_tracker->getX(), _tracker->getY())) {
-                completeSound.play();
-                //mark as completed
-                reset();
-                int* courseNum = ((selection*)parent)->getCurrentCourse();
-                int totalCourses = ((selection*)parent)->getNumCourses();
-                if (continuous && *courseNum != totalCourses - 1) {
-                    (*courseNum)++;
-                    setNextCourse(((selection*)parent)->getCoursePath(*courseNum));
-                }
-                else {
-                    ((selection*)parent)->setMode(SELECTING);
-                }
-            }
+    double measured = _tracker->getSampleTime();
+    if (measured != sampleTime) {
+        lastSampleTime = sampleTime;
+        sampleTime = measured;
+        for (int i = 0; i < numPlayers; i++) {
+            lastSamples[i] = samples[i];
+            samples[i] = _tracker->getTarget(i);
         }
-        else {
-            reset();
+    }
+    if (sampleTime > 0 && (!hasSample || sampleTime - simTime > GAME_MAX_STEPS * GAME_STEP)) {
+        for (int i = 0; i < numPlayers; i++) {
+            samples[i] = lastSamples[i] = _tracker->getTarget(i);
         }
+        lastSampleTime = sampleTime;
+        simTime = sampleTime - GAME_STEP;
+        hasSample = true;
     }
-    else {
-        if (withinCircle(ofPoint(_tracker->getX(), _tracker->getY()), gameCourse.start, IMP_NODE_SIZE)) drawing = true;
+
+    ofPoint positions[MAX_PLAYERS];
+    while (hasSample && simTime + GAME_STEP <= sampleTime) {
+        simTime += GAME_STEP;
+        float t = 1;
+        if (sampleTime > lastSampleTime) t = (simTime - lastSampleTime) / (sampleTime - lastSampleTime);
+        t = max(0.0f, min(1.0f, t));
+        for (int i = 0; i < numPlayers; i++) {
+            positions[i] = lastSamples[i] + (samples[i] - lastSamples[i]) * t;
+        }
+        if (step(positions)) break;
     }
+
+    prefetch();
+
     if (transition) {
         fader.updateFade();
         if (fader.getAlpha() > 0.9f && fader.isFadingIn()) {
-            if (!setCourseFromString(nextCourse)) ((selection*)parent)->setMode(SELECTING);
+            if (!swapCourse(nextCourse)) ((selection*)parent)->setMode(SELECTING);
             else {fader.fadeOut();}
         }
         if (fader.getAlpha() < 0.1f && fader.isFadingOut()) transition = false;
@@ -100,27 +133,142 @@ void game::update() {
 }
 
 /*
- * Draws the game application.  Draws the course, and if drawing, 
- * the current line.
+ * Runs one step of the game rules.  Turns each player's screen position 
+ * into a course position, gives it to their run, and checks for win/loss 
+ * conditions.  A player who crashes goes back to the start on their own; 
+ * the first to reach the finish completes the course for everyone.  Runs 
+ * are only recorded with one player.  During a run the camera follows 
+ * the player, otherwise it heads back to the start.  In a race the 
+ * camera stays on the start: every player's course position depends on 
+ * it, so one player scrolling would move everyone else's line.  Returns 
+ * true if the course was completed, so no more steps should run this 
+ * frame.
+ */
+bool game::step(ofPoint* screenPositions) {
+    bool solo = numPlayers == 1;
+    int completed = -1;
+    for (int i = 0; i < numPlayers && completed < 0; i++) {
+        ofPoint position = camera.toCourse(screenPositions[i]);
+        int state = players[i].update(position);
+        if (solo && state == RUN_STARTED) {
+            runStart = simTime;
+            if (ghostPath != "") recorder.begin(ofToDataPath(ghostPath + ".tmp"));
+            ghost.rewind();
+        }
+        else if (solo && state != RUN_WAITING) {
+            unsigned int runTime = (unsigned int)((simTime - runStart) * 1000 + 0.5);
+            recorder.add(runTime, position);
+            ghost.update(runTime);
+        }
+
+        if (state == RUN_COMPLETE) completed = i;
+        else if (state == RUN_CRASHED && solo) reset();
+    }
+    if (!solo) camera.center(gameCourse->start);
+    else if (players[0].isDrawing()) camera.follow(screenPositions[0], GAME_STEP);
+    else {camera.approach(gameCourse->start, GAME_STEP);}
+    followField();
+
+    if (completed >= 0) {
+        completeSound.play();
+        if (solo) saveRun();
+        winner = completed;
+        //mark as completed
+        reset();
+        int* courseNum = ((selection*)parent)->getCurrentCourse();
+        int totalCourses = ((selection*)parent)->getNumCourses();
+        if (continuous && *courseNum != totalCourses - 1) {
+            (*courseNum)++;
+            setNextCourse(((selection*)parent)->getCoursePath(*courseNum));
+        }
+        else {
+            ((selection*)parent)->setMode(SELECTING);
+        }
+    }
+    return completed >= 0;
+}
+
+/*
+ * Keeps a collision field around the view, for courses too big to 
+ * have one of their own.  The field reaches FIELD_VIEW_MARGIN past 
+ * the view, and is built again once the view gets close to leaving 
+ * it.  If it can't be built, the run goes without.
+ */
+void game::followField() {
+    if (wholeField) return;
+    ofRectangle view = camera.getViewBounds();
+    float near = FIELD_VIEW_MARGIN / 8;
+    if (gameField->covers(ofRectangle(view.x - near, view.y - near, view.width + 2 * near, view.height + 2 * near))) return;
+    bool built = gameField->build(gameCourse, ofRectangle(view.x - FIELD_VIEW_MARGIN, view.y - FIELD_VIEW_MARGIN,
+                                                          view.width + 2 * FIELD_VIEW_MARGIN, view.height + 2 * FIELD_VIEW_MARGIN));
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        players[i].setField(built ? gameField : 0);
+    }
+}
+
+/*
+ * Draws the game application.  Draws the part of the course in 
+ * view, the lines of the players who are drawing, all together, and 
+ * with one player the ghost of the best run.  Where a player's last 
+ * line hit an edge is marked.  After a race, shows who won.
  */
 void game::draw() {
     ofPushStyle();
-    gameCourse.draw();
-    if (drawing) {
-        for (int i = 0; i < currentLine.size(); i++) {
-            currentLine[i].draw(&edgeImg);
-            //ofSetRectMode(OF_RECTMODE_CENTER);
-            //ofSetColor(255, 255, 255);
-            //nodeImg.draw(currentLine[i].p1->x, currentLine[i].p1->y, 12, 12);
+    ofPoint view = camera.getView();
+    ofPushMatrix();
+    ofTranslate(-view.x, -view.y, 0);
+    gameCourse->draw(view);
+    if (numPlayers == 1 && players[0].isDrawing() && ghost.isOpen()) {
+        ofSetRectMode(OF_RECTMODE_CENTER);
+        ofSetColor(255, 255, 255, 120);
+        nodeImg.draw(ghost.getPosition().x, ghost.getPosition().y, NODE_SIZE * 2, NODE_SIZE * 2);
+    }
+
+    int numTrails = 0;
+    for (int i = 0; i < numPlayers; i++) {
+        if (players[i].isDrawing()) drawnTrails[numTrails++] = players[i].getTrail();
+    }
+    trail::drawAll(drawnTrails, numTrails);
+
+    for (int i = 0; i < numPlayers; i++) {
+        if (players[i].isDrawing()) {
+            //bridge the trail to the position latched right before drawing
+            drawBridge(players[i].getTrail()->getLatest(), camera.toCourse(_tracker->getDrawTarget(i)), i);
+        }
+        else if (players[i].hasImpact()) {
+            ofSetRectMode(OF_RECTMODE_CENTER);
+            ofSetColor(playerColors[i][0], playerColors[i][1], playerColors[i][2]);
+            nodeImg.draw(players[i].getImpact().x, players[i].getImpact().y, NODE_SIZE, NODE_SIZE);
         }
     }
+    ofPopMatrix();
     GUI.draw();
     if (transition) {
         fader.draw(0, 0, ofGetWidth(), ofGetHeight());
+        if (numPlayers > 1 && winner >= 0) {
+            ofSetColor(playerColors[winner][0], playerColors[winner][1], playerColors[winner][2]);
+            ofDrawBitmapString("Player " + ofToString(winner + 1) + " wins", ofGetWidth() / 2 - 50, ofGetHeight() / 2);
+        }
     }
     ofPopStyle();
 }
 
+/*
+ * Draws a piece of line from a to b in the given player's color, 
+ * the same way edges are drawn.
+ */
+void game::drawBridge(ofPoint a, ofPoint b, int playerNum) {
+    float length = sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+    if (length == 0) return;
+    ofPushMatrix();
+    ofTranslate(a.x, a.y, 0);
+    glRotatef(atan2(b.y - a.y, b.x - a.x) * 180 / PI, 0, 0, 1);
+    ofSetRectMode(OF_RECTMODE_CORNER);
+    ofSetColor(playerColors[playerNum][0], playerColors[playerNum][1], playerColors[playerNum][2]);
+    edgeImg.draw(0, -EDGE_WIDTH / 2, length, EDGE_WIDTH);
+    ofPopMatrix();
+}
+
 /*
  * Handles mouse presses.
  */
@@ -132,61 +280,150 @@ void game::mousePressed(int x, int y, int button) {
 }
 
 /*
- * Sets the current course from a string specifying the course name.
+ * Sets the current course from a string specifying the course name, 
+ * and prepares its edges for out of bounds checks.
  */
 bool game::setCourseFromString(string courseName) {
     XMLUtil xml;
-    return xml.loadCourse(courseName, &gameCourse);
+    bool loaded = xml.loadCourse(courseName, gameCourse);
+    useCourse(loaded ? courseName : "", gameField->build(gameCourse));
+    return loaded;
 }
 
 /*
- * Sets the next course from a string specifying the course name.
+ * Switches to the given course.  If it is the one loaded in the 
+ * background, the loaded course just takes the place of the current 
+ * one.  Otherwise it is loaded now.
  */
-void game::setNextCourse(string course) {
-    transition = true;
-    nextCourse = course;
-    fader.setAlpha(0);
-    fader.fadeIn();
+bool game::swapCourse(string courseName) {
+    if (loader.getPath() == courseName) {
+        loader.wait();
+        if (loader.getLoaded()) {
+            gameCourse = gameCourse == &courses[0] ? &courses[1] : &courses[0];
+            gameField = gameField == &fields[0] ? &fields[1] : &fields[0];
+            useCourse(courseName, loader.getUseField());
+            gameCourse->prepare(camera.getView());
+            loader.clear();
+            return true;
+        }
+        loader.clear();
+    }
+    return setCourseFromString(courseName);
 }
 
 /*
- * Returns if the course has been completed. i.e. if the user is 
- * still drawing and they are in the finishing spot.
+ * Starts playing the current course, which has been loaded from the 
+ * given course name.  Looks at its start, and if its collision field 
+ * couldn't cover all of it, builds one around the view.  Opens the 
+ * best run of the course, if there is one, to play back as a ghost, 
+ * and asks for the next course to be loaded.
  */
-bool game::courseComplete(int x, int y) {
-    return drawing && withinCircle(ofPoint(x, y), gameCourse.finish, IMP_NODE_SIZE);
+void game::useCourse(string courseName, bool useField) {
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        players[i].setCourse(gameCourse, useField ? gameField : 0);
+    }
+    camera.setCourse(gameCourse);
+    wholeField = useField;
+    followField();
+
+    recorder.cancel();
+    ghostPath = "";
+    if (courseName != "") {
+        string path = getGhostPath(courseName);
+        if (ofDirectory::createDirectory(ofToDataPath(path.substr(0, path.find_last_of('/')), true), false, true)) {
+            ghostPath = path;
+        }
+    }
+    if (ghostPath != "") ghost.open(ofToDataPath(ghostPath));
+    else {ghost.close();}
+    prefetchPending = courseName != "";
 }
 
 /*
- * Returns if the current line has intersected with any edge 
- * of the course.
- * TODO THIS IS INCOSISTENT.  DOES NOT ALWAYS CORRECTLY DETERMINE IF 
- * AN EDGE HAS BEEN CROSSED.
+ * Loads the course after the current one in the background, into 
+ * the course that isn't being played.  This waits until the selection 
+ * screen has said which course is current.  Once loaded, the course 
+ * is drawn into its layer here, as seen from its start, so switching 
+ * to it only swaps pointers.
  */
-bool game::outOfBounds() {
-    if (currentLine.size() > 0) {
-        for (list<edge>::iterator it = gameCourse.edges.begin(); it != gameCourse.edges.end(); it++) {
-            if (currentLine.back().intersects(&*it)) return true;
+void game::prefetch() {
+    if (prefetchPending && !transition) {
+        prefetchPending = false;
+        nextPrepared = false;
+        int next = *((selection*)parent)->getCurrentCourse() + 1;
+        if (next < ((selection*)parent)->getNumCourses()) {
+            course* spareCourse = gameCourse == &courses[0] ? &courses[1] : &courses[0];
+            collisionField* spareField = gameField == &fields[0] ? &fields[1] : &fields[0];
+            loader.load(((selection*)parent)->getCoursePath(next), spareCourse, spareField);
         }
+        else {loader.clear();}
+    }
+    if (!nextPrepared && loader.isDone()) {
+        if (loader.getLoaded()) {
+            course* spareCourse = gameCourse == &courses[0] ? &courses[1] : &courses[0];
+            courseCamera spareCamera;
+            spareCamera.setCourse(spareCourse);
+            spareCourse->prepare(spareCamera.getView());
+        }
+        nextPrepared = true;
     }
-    return false;
 }
 
 /*
- * Returns whether or not the point position is within the 
- * circle at point center with the given radius.
+ * Finishes recording the run that was just completed.  If it was 
+ * faster than the best run of the course, it replaces it and 
+ * becomes the ghost.  Otherwise it is thrown away.
  */
-bool game::withinCircle(ofPoint position, ofPoint center, int radius) {
-    return pow((position.x - center.x), 2) + pow((position.y - center.y), 2) <= pow((double)radius, 2);
+void game::saveRun() {
+    unsigned int duration = (unsigned int)((simTime - runStart) * 1000 + 0.5);
+    if (!recorder.finish(duration)) return;
+    string best = ofToDataPath(ghostPath);
+    string run = ofToDataPath(ghostPath + ".tmp");
+    if (!ghost.isOpen() || duration < ghost.getDuration()) {
+        ghost.close();
+        remove(best.c_str());
+        rename(run.c_str(), best.c_str());
+        ghost.open(best);
+    }
+    else {remove(run.c_str());}
+}
+
+/*
+ * Sets the next course from a string specifying the course name.
+ */
+void game::setNextCourse(string course) {
+    transition = true;
+    nextCourse = course;
+    fader.setAlpha(0);
+    fader.fadeIn();
 }
 
 /*
  * Resets the game.
  */
 void game::reset() {
-    drawing = false;
-    previousPoints.clear();
-    currentLine.clear();
+    for (int i = 0; i < numPlayers; i++) {
+        players[i].reset();
+    }
+    recorder.cancel();
+}
+
+/*
+ * Sets how many players race, from 1 to MAX_PLAYERS, and has the 
+ * tracker follow a target for each.
+ */
+void game::setNumPlayers(int _numPlayers) {
+    numPlayers = max(1, min(MAX_PLAYERS, _numPlayers));
+    _tracker->setNumTargets(numPlayers);
+    hasSample = false;
+    reset();
+}
+
+/*
+ * Returns how many players race.
+ */
+int game::getNumPlayers() {
+    return numPlayers;
 }
 
 /*
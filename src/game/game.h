@@ -7,7 +7,15 @@
  *
  * Description:  Handles the gameplay of the application.
  * Draws the current course and tests the input to see 
- * if the course has been completed.
+ * if the course has been completed.  The game rules run at a 
+ * fixed GAME_RATE steps per second, no matter how fast frames 
+ * are drawn.  In a continuous game, the next course is loaded 
+ * in the background while the current one is played.  Courses 
+ * bigger than the screen scroll with the player.  Up to 
+ * MAX_PLAYERS can race on the same course, each following their 
+ * own target; the first to reach the finish wins.  Races are seen 
+ * from the start and don't scroll, so they are best run on courses 
+ * that fit on the screen.
  *
  */
 
@@ -19,8 +27,19 @@
 #include "tracker.h"
 #include "gui.h"
 #include "course.h"
+#include "collisionField.h"
+#include "playerRun.h"
+#include "courseLoader.h"
+#include "courseCamera.h"
+#include "ghostRun.h"
 #include "ofxFadable.h"
 
+#define GAME_RATE 120
+#define GAME_STEP (1.0 / GAME_RATE)
+#define GAME_MAX_STEPS 12
+#define FIELD_VIEW_MARGIN 512
+#define MAX_PLAYERS MAX_TARGETS
+
 class game : public ofBaseApp {
 
     public:
@@ -34,30 +53,52 @@ class game : public ofBaseApp {
         void mousePressed(int x, int y, int button);
 
         bool* getContinuous();
+        void setNumPlayers(int _numPlayers);
+        int getNumPlayers();
         bool setCourseFromString(string course);
         void setNextCourse(string course);
     
     private:
 
         void setupGUI();
-        bool courseComplete(int x, int y);
-        bool outOfBounds();
-        bool withinCircle(ofPoint position, ofPoint center, int radius);
+        bool step(ofPoint* screenPositions);
+        bool swapCourse(string courseName);
+        void useCourse(string courseName, bool useField);
+        void prefetch();
+        void followField();
+        void saveRun();
+        void drawBridge(ofPoint a, ofPoint b, int playerNum);
         
         ofBaseApp* parent;
         tracker* _tracker;
         ofSoundPlayer completeSound;
         ofxFadableRect fader;
 
-        bool drawing, transition, continuous;
+        bool transition, continuous;
         string nextCourse;
 
-        course gameCourse;
-        list<ofPoint> previousPoints;
-        vector<edge> currentLine;
+        course courses[2];
+        collisionField fields[2];
+        course* gameCourse;
+        collisionField* gameField;
+        courseLoader loader;
+        bool prefetchPending, nextPrepared, wholeField;
+        playerRun players[MAX_PLAYERS];
+        trail* drawnTrails[MAX_PLAYERS];
+        int numPlayers, winner;
+        courseCamera camera;
 
         ofImage edgeImg, nodeImg;
 
+        ghostRecorder recorder;
+        ghostPlayer ghost;
+        string ghostPath;
+        double runStart;
+
+        double simTime, sampleTime, lastSampleTime;
+        ofPoint samples[MAX_PLAYERS], lastSamples[MAX_PLAYERS];
+        bool hasSample;
+
         gui GUI;
         guiButton backBut;        
 };
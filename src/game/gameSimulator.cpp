@@ -0,0 +1,262 @@
+/*
+ * gameSimulator.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Plays position traces through the game rules 
+ * without a camera or drawing anything, to check that courses 
+ * still play the way they should and to time the collision 
+ * checks.  Every course gets a straight line from its start to 
+ * its finish, and its best recorded run if it has one.  Those 
+ * must end the way checking every edge of the course directly 
+ * says they should: completed, or crashed at the same place.  So 
+ * the collision field and the spatial index are checked against 
+ * the plain geometry on every course, with nothing to set up. 
+ * More cases, with the outcome they expect, can be listed in 
+ * settings/simulation.xml.
+ *
+ */
+
+#include "gameSimulator.h"
+#include "ghostRun.h"
+#include "XMLUtil.h"
+#include "math.h"
+
+/*
+ * Default constructor.  No cases.
+ */
+gameSimulator::gameSimulator() {
+}
+
+/*
+ * Adds a case to play.
+ */
+void gameSimulator::addCase(simulationCase c) {
+    cases.push_back(c);
+}
+
+/*
+ * Adds the default cases for every course in the given directory: 
+ * a straight line from start to finish, and the course's best run. 
+ * Both are checked against the reference.  Best runs are rounded to 
+ * whole pixels when recorded, so one that grazed an edge may crash 
+ * when played back; it only has to do so where the reference says.
+ */
+void gameSimulator::addCourses(string directory) {
+    ofDirectory dir;
+    int numFiles = dir.listDir(directory);
+    for (int i = 0; i < numFiles; i++) {
+        string name = dir.getName(i);
+        if (name.length() < 4 || name.substr(name.length() - 4) != ".xml") continue;
+
+        simulationCase line;
+        line.course = dir.getPath(i);
+        line.expect = SIM_EXPECT_REFERENCE;
+        line.checkCrash = false;
+        line.tolerance = SIM_REFERENCE_TOLERANCE;
+        addCase(line);
+
+        simulationCase best = line;
+        best.trace = getGhostPath(line.course);
+        ghostPlayer ghost;
+        if (ghost.open(ofToDataPath(best.trace))) addCase(best);
+    }
+}
+
+/*
+ * Plays every case and writes the report to the simulation 
+ * folder.  Returns if every case passed.
+ */
+bool gameSimulator::run() {
+    text = "";
+    bool passed = true;
+    int numPassed = 0;
+    for (int i = 0; i < cases.size(); i++) {
+        course simCourse;
+        XMLUtil xml;
+        vector<ofPoint> trace;
+        simulationResult result, expected;
+        if (!xml.loadCourse(cases[i].course, &simCourse) || !getTrace(cases[i], &simCourse, trace)) {
+            result.outcome = RUN_WAITING;
+            result.samples = result.checks = 0;
+            result.checkMicros = result.maxCheckMicros = 0;
+            result.passed = false;
+        }
+        else {
+            collisionField field;
+            playerRun player;
+            player.setCourse(&simCourse, field.build(&simCourse) ? &field : 0);
+            result = play(trace, &player);
+            if (cases[i].expect == SIM_EXPECT_REFERENCE) expected = reference(trace, &simCourse);
+            result.passed = check(cases[i], result, expected);
+        }
+        report(cases[i], result, expected);
+        passed = passed && result.passed;
+        if (result.passed) numPassed++;
+    }
+    text += ofToString(numPassed) + " of " + ofToString((int)cases.size()) + " cases passed\n";
+
+    cout << text;
+    string directory = ofToDataPath(SIM_DIR, true);
+    if (ofDirectory::createDirectory(directory, false, true)) {
+        ofstream out((directory + "/report-" + ofToString((int)ofGetUnixTime()) + ".txt").c_str());
+        out << text;
+    }
+    return passed;
+}
+
+/*
+ * Returns the report of the last run.
+ */
+string gameSimulator::getReport() {
+    return text;
+}
+
+/*
+ * Gets the positions a case plays, starting at the start of the 
+ * course: its recorded run, its points, or a straight line to the 
+ * finish.  Returns false if the recorded run couldn't be opened.
+ */
+bool gameSimulator::getTrace(simulationCase& c, course* simCourse, vector<ofPoint>& trace) {
+    trace.clear();
+    trace.push_back(simCourse->start);
+    if (c.trace != "") {
+        ghostPlayer ghost;
+        if (!ghost.open(ofToDataPath(c.trace))) return false;
+        ofPoint position;
+        unsigned int time;
+        while (ghost.readSample(&time, &position)) {
+            trace.push_back(position);
+        }
+    }
+    else if (c.points.size() > 0) {
+        trace.insert(trace.end(), c.points.begin(), c.points.end());
+    }
+    else {
+        ofPoint from = simCourse->start;
+        ofPoint to = simCourse->finish;
+        int numSteps = (int)ceil(sqrt(pow(to.x - from.x, 2) + pow(to.y - from.y, 2)) / SIM_STEP);
+        for (int i = 0; i < numSteps; i++) {
+            trace.push_back(from + (to - from) * ((float)(i + 1) / numSteps));
+        }
+    }
+    return true;
+}
+
+/*
+ * Feeds a trace to the player's run until the run ends or the 
+ * trace runs out.  Times every collision check along the way.
+ */
+simulationResult gameSimulator::play(vector<ofPoint>& trace, playerRun* player) {
+    simulationResult result;
+    result.outcome = RUN_WAITING;
+    result.samples = 0;
+    result.checks = 0;
+    result.checkMicros = 0;
+    result.maxCheckMicros = 0;
+
+    for (int i = 0; i < trace.size() && result.outcome != RUN_CRASHED && result.outcome != RUN_COMPLETE; i++) {
+        result.outcome = player->update(trace[i]);
+        result.samples++;
+        if (result.outcome == RUN_DRAWING || result.outcome == RUN_CRASHED || result.outcome == RUN_COMPLETE) {
+            double micros = player->getCheckMicros();
+            result.checks++;
+            result.checkMicros += micros;
+            result.maxCheckMicros = max(result.maxCheckMicros, micros);
+        }
+    }
+    result.impact = player->getImpact();
+    return result;
+}
+
+/*
+ * Plays a trace by the same rules as a player's run, but sweeps 
+ * every piece of it against every edge of the course, without the 
+ * collision field or the spatial index.  Returns how the run ends 
+ * and where it crashed, if it did.
+ */
+simulationResult gameSimulator::reference(vector<ofPoint>& trace, course* simCourse) {
+    simulationResult result;
+    result.outcome = RUN_WAITING;
+    result.samples = result.checks = 0;
+    result.checkMicros = result.maxCheckMicros = 0;
+    float radius = EDGE_WIDTH / 2.0f;
+    float reach = (float)IMP_NODE_SIZE * IMP_NODE_SIZE;
+    bool drawing = false;
+    for (int i = 0; i < trace.size(); i++) {
+        ofPoint position = trace[i];
+        result.samples++;
+        if (!drawing) {
+            ofPoint d = position - simCourse->start;
+            drawing = d.x * d.x + d.y * d.y <= reach;
+            if (drawing) result.outcome = RUN_STARTED;
+            continue;
+        }
+        if (result.outcome == RUN_DRAWING) {
+            ofPoint previous = trace[i - 1];
+            float first = -1;
+            for (list<edge>::iterator it = simCourse->edges.begin(); it != simCourse->edges.end(); it++) {
+                float t = it->sweep(previous, position, radius);
+                if (t >= 0 && (first < 0 || t < first)) first = t;
+            }
+            if (first >= 0) {
+                result.outcome = RUN_CRASHED;
+                result.impact = previous + (position - previous) * first;
+                return result;
+            }
+        }
+        result.outcome = RUN_DRAWING;
+        ofPoint d = position - simCourse->finish;
+        if (d.x * d.x + d.y * d.y <= reach) {
+            result.outcome = RUN_COMPLETE;
+            return result;
+        }
+    }
+    return result;
+}
+
+/*
+ * Returns if the result is what the case expects.  Reference cases 
+ * are compared with what the reference gave.
+ */
+bool gameSimulator::check(simulationCase& c, simulationResult& result, simulationResult& expected) {
+    if (c.expect == SIM_EXPECT_REFERENCE) {
+        if (result.outcome != expected.outcome) return false;
+        if (result.outcome == RUN_CRASHED && pow(result.impact.x - expected.impact.x, 2) + pow(result.impact.y - expected.impact.y, 2) > pow(c.tolerance, 2)) return false;
+        return true;
+    }
+    if (c.expect == SIM_EXPECT_COMPLETE && result.outcome != RUN_COMPLETE) return false;
+    if (c.expect == SIM_EXPECT_CRASH) {
+        if (result.outcome != RUN_CRASHED) return false;
+        if (c.checkCrash && pow(result.impact.x - c.crash.x, 2) + pow(result.impact.y - c.crash.y, 2) > pow(c.tolerance, 2)) return false;
+    }
+    return true;
+}
+
+/*
+ * Adds a line about a case to the report.  A reference case that 
+ * failed also says what the reference gave.
+ */
+void gameSimulator::report(simulationCase& c, simulationResult& result, simulationResult& expected) {
+    string line = c.course + " (" + (c.trace != "" ? c.trace : (c.points.size() > 0 ? "points" : "straight line")) + "): ";
+    if (result.outcome == RUN_COMPLETE) line += "completed";
+    else if (result.outcome == RUN_CRASHED) {
+        line += "crashed at " + ofToString(result.impact.x, 1) + ", " + ofToString(result.impact.y, 1);
+    }
+    else if (result.samples == 0) line += "could not load";
+    else {line += "unfinished";}
+
+    line += " after " + ofToString(result.samples) + " samples, ";
+    double mean = result.checks > 0 ? result.checkMicros / result.checks : 0;
+    line += ofToString(mean, 2) + " us per check, " + ofToString(result.maxCheckMicros, 0) + " us max";
+    if (c.expect == SIM_EXPECT_REFERENCE && !result.passed && result.samples > 0) {
+        if (expected.outcome == RUN_COMPLETE) line += ", reference completed";
+        else if (expected.outcome == RUN_CRASHED) {
+            line += ", reference crashed at " + ofToString(expected.impact.x, 1) + ", " + ofToString(expected.impact.y, 1);
+        }
+        else {line += ", reference unfinished";}
+    }
+    text += (result.passed ? "pass  " : "FAIL  ") + line + "\n";
+}
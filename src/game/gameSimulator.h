@@ -0,0 +1,86 @@
+/*
+ * gameSimulator.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Plays position traces through the game rules 
+ * without a camera or drawing anything, to check that courses 
+ * still play the way they should and to time the collision 
+ * checks.  Every course gets a straight line from its start to 
+ * its finish, and its best recorded run if it has one.  Those 
+ * must end the way checking every edge of the course directly 
+ * says they should: completed, or crashed at the same place.  So 
+ * the collision field and the spatial index are checked against 
+ * the plain geometry on every course, with nothing to set up. 
+ * More cases, with the outcome they expect, can be listed in 
+ * settings/simulation.xml.
+ *
+ */
+
+#ifndef _GAME_SIMULATOR_H
+#define _GAME_SIMULATOR_H
+
+#include "ofMain.h"
+#include "ofTypes.h"
+#include "playerRun.h"
+
+#define SIM_STEP 4
+#define SIM_DIR string("simulation")
+#define SIM_REFERENCE_TOLERANCE 0.5f
+
+enum {SIM_EXPECT_ANY, SIM_EXPECT_COMPLETE, SIM_EXPECT_CRASH, SIM_EXPECT_REFERENCE};
+
+/*
+ * A trace to play and what should happen.  The trace is either 
+ * a recorded run or a list of points.  A crash can also be 
+ * expected within tolerance of a position.  A reference case 
+ * expects what checking every edge directly gives.
+ */
+struct simulationCase {
+    string course;
+    string trace;
+    vector<ofPoint> points;
+    int expect;
+    bool checkCrash;
+    ofPoint crash;
+    float tolerance;
+};
+
+/*
+ * What happened when a case was played.
+ */
+struct simulationResult {
+    int outcome;
+    ofPoint impact;
+    int samples;
+    int checks;
+    double checkMicros, maxCheckMicros;
+    bool passed;
+};
+
+class gameSimulator {
+
+    public:
+
+        gameSimulator();
+
+        void addCase(simulationCase c);
+        void addCourses(string directory);
+        bool run();
+        string getReport();
+
+    private:
+
+        bool getTrace(simulationCase& c, course* simCourse, vector<ofPoint>& trace);
+        simulationResult play(vector<ofPoint>& trace, playerRun* player);
+        simulationResult reference(vector<ofPoint>& trace, course* simCourse);
+        bool check(simulationCase& c, simulationResult& result, simulationResult& expected);
+        void report(simulationCase& c, simulationResult& result, simulationResult& expected);
+
+        vector<simulationCase> cases;
+        string text;
+};
+
+#endif
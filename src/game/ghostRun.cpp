@@ -0,0 +1,340 @@
+/*
+ * ghostRun.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Records runs through a course and plays the best 
+ * one back as a ghost.  A run is a file with a short header and 
+ * one record per sample: the time and position since the last 
+ * sample, rounded to milliseconds and pixels and stored as 
+ * variable length integers.  Most records take three bytes.  The 
+ * recorder encodes into a fixed buffer and appends it to the file 
+ * when full, and the player reads the file through a small buffer, 
+ * so neither keeps a whole run in memory or allocates while a 
+ * game is being played.  A course's best run is kept under 
+ * GHOST_DIR at the course's path within courses/, so courses with 
+ * the same name in different directories keep their own.
+ *
+ */
+
+#include "ghostRun.h"
+#include "math.h"
+
+static const unsigned char GHOST_MAGIC[4] = {'F', 'T', 'G', '1'};
+
+/*
+ * Maps signed values to unsigned ones so small negative steps 
+ * stay small: 0, -1, 1, -2, 2 become 0, 1, 2, 3, 4.
+ */
+static unsigned int zigzag(int value) {
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+/*
+ * Undoes zigzag.
+ */
+static int unzigzag(unsigned int value) {
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+/*
+ * Returns where the best run of the course at the given path is 
+ * kept, relative to the data folder.  "courses/user/foo.xml" has 
+ * its best run in "ghosts/user/foo.ghost".
+ */
+string getGhostPath(string coursePath) {
+    string path = coursePath;
+    for (int i = 0; i < path.length(); i++) {
+        if (path[i] == '\\') path[i] = '/';
+    }
+    size_t courses = path.rfind("courses/");
+    if (courses != string::npos) path = path.substr(courses + 8);
+    size_t repeated;
+    while ((repeated = path.find("//")) != string::npos) {
+        path.erase(repeated, 1);
+    }
+    if (path.length() > 0 && path[0] == '/') path = path.substr(1);
+    size_t extension = path.find_last_of('.');
+    if (extension != string::npos && path.find('/', extension) == string::npos) path = path.substr(0, extension);
+    return GHOST_DIR + "/" + path + ".ghost";
+}
+
+/*
+ * Writes a 32 bit value, least significant byte first.
+ */
+static void putWord(unsigned char* out, unsigned int value) {
+    for (int i = 0; i < 4; i++) out[i] = (value >> (8 * i)) & 0xFF;
+}
+
+/*
+ * Reads a 32 bit value, least significant byte first.
+ */
+static unsigned int getWord(const unsigned char* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+/*
+ * Default constructor.
+ */
+ghostRecorder::ghostRecorder() {
+    file = 0;
+    used = 0;
+}
+
+/*
+ * Destructor.  Throws away an unfinished run.
+ */
+ghostRecorder::~ghostRecorder() {
+    cancel();
+}
+
+/*
+ * Starts recording a run into the given file, replacing whatever 
+ * was there.  The header is filled in when the run is finished.
+ */
+bool ghostRecorder::begin(string _path) {
+    cancel();
+    path = _path;
+    file = fopen(path.c_str(), "wb");
+    if (file == 0) return false;
+    memset(buffer, 0, GHOST_HEADER);
+    used = GHOST_HEADER;
+    count = 0;
+    lastTime = 0;
+    lastX = 0;
+    lastY = 0;
+    return true;
+}
+
+/*
+ * Adds a sample at the given time, in milliseconds since the 
+ * run started.  Samples are expected in time order.
+ */
+void ghostRecorder::add(unsigned int time, ofPoint position) {
+    if (file == 0) return;
+    //a record is at most three 5 byte varints
+    if (used > GHOST_BUFFER - 15) flush();
+
+    int x = (int)floor(position.x + 0.5f);
+    int y = (int)floor(position.y + 0.5f);
+    putVarint(time >= lastTime ? time - lastTime : 0);
+    putVarint(zigzag(x - lastX));
+    putVarint(zigzag(y - lastY));
+    lastTime = max(time, lastTime);
+    lastX = x;
+    lastY = y;
+    count++;
+}
+
+/*
+ * Finishes the run, writing its length and number of samples 
+ * into the header.  Returns if the file was written.
+ */
+bool ghostRecorder::finish(unsigned int duration) {
+    if (file == 0) return false;
+    flush();
+    unsigned char header[GHOST_HEADER];
+    memcpy(header, GHOST_MAGIC, 4);
+    putWord(header + 4, duration);
+    putWord(header + 8, count);
+    bool written = fseek(file, 0, SEEK_SET) == 0 && fwrite(header, 1, GHOST_HEADER, file) == GHOST_HEADER;
+    written = fclose(file) == 0 && written;
+    file = 0;
+    if (!written) remove(path.c_str());
+    return written;
+}
+
+/*
+ * Stops recording and deletes the unfinished run.
+ */
+void ghostRecorder::cancel() {
+    if (file == 0) return;
+    fclose(file);
+    file = 0;
+    remove(path.c_str());
+}
+
+/*
+ * Returns if a run is being recorded.
+ */
+bool ghostRecorder::isRecording() {
+    return file != 0;
+}
+
+/*
+ * Adds an unsigned value to the buffer, seven bits per byte, with 
+ * the high bit set on every byte but the last.
+ */
+void ghostRecorder::putVarint(unsigned int value) {
+    while (value >= 0x80) {
+        buffer[used++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buffer[used++] = value;
+}
+
+/*
+ * Appends the buffer to the file and empties it.
+ */
+void ghostRecorder::flush() {
+    if (used > 0) fwrite(buffer, 1, used, file);
+    used = 0;
+}
+
+/*
+ * Default constructor.
+ */
+ghostPlayer::ghostPlayer() {
+    file = 0;
+    duration = 0;
+}
+
+/*
+ * Destructor.
+ */
+ghostPlayer::~ghostPlayer() {
+    close();
+}
+
+/*
+ * Opens a recorded run and moves to its start.  Returns false if 
+ * there is no finished run in the file.
+ */
+bool ghostPlayer::open(string path) {
+    close();
+    file = fopen(path.c_str(), "rb");
+    if (file == 0) return false;
+    unsigned char header[GHOST_HEADER];
+    if (fread(header, 1, GHOST_HEADER, file) != GHOST_HEADER || memcmp(header, GHOST_MAGIC, 4) != 0) {
+        close();
+        return false;
+    }
+    duration = getWord(header + 4);
+    count = getWord(header + 8);
+    rewind();
+    return true;
+}
+
+/*
+ * Closes the run.
+ */
+void ghostPlayer::close() {
+    if (file != 0) fclose(file);
+    file = 0;
+    duration = 0;
+    hasNext = false;
+}
+
+/*
+ * Returns if a run is open.
+ */
+bool ghostPlayer::isOpen() {
+    return file != 0;
+}
+
+/*
+ * Goes back to the start of the run.
+ */
+void ghostPlayer::rewind() {
+    if (file == 0) return;
+    fseek(file, GHOST_HEADER, SEEK_SET);
+    used = 0;
+    pos = 0;
+    read = 0;
+    nextTime = 0;
+    nextPosition = ofPoint(0, 0);
+    hasNext = readNext();
+    time = nextTime;
+    position = nextPosition;
+}
+
+/*
+ * Moves the ghost to where it was at the given time, in 
+ * milliseconds since the run started.  Only the records up to 
+ * that time are read.
+ */
+void ghostPlayer::update(unsigned int _time) {
+    if (file == 0) return;
+    while (hasNext && nextTime <= _time) {
+        time = nextTime;
+        position = nextPosition;
+        hasNext = readNext();
+    }
+    if (hasNext && nextTime > time && _time > time) {
+        float t = (float)(_time - time) / (nextTime - time);
+        position = position + (nextPosition - position) * min(t, 1.0f);
+        time = _time;
+    }
+}
+
+/*
+ * Reads the next recorded sample as it was recorded, instead of 
+ * following the run in time with update.  Returns false at the 
+ * end of the run.
+ */
+bool ghostPlayer::readSample(unsigned int* _time, ofPoint* _position) {
+    if (file == 0 || !hasNext) return false;
+    *_time = nextTime;
+    *_position = nextPosition;
+    hasNext = readNext();
+    return true;
+}
+
+/*
+ * Returns how long the run took, in milliseconds.
+ */
+unsigned int ghostPlayer::getDuration() {
+    return duration;
+}
+
+/*
+ * Returns where the ghost is.
+ */
+ofPoint ghostPlayer::getPosition() {
+    return position;
+}
+
+/*
+ * Reads the next record into nextTime and nextPosition.  Returns 
+ * false at the end of the run.
+ */
+bool ghostPlayer::readNext() {
+    if (read >= count) return false;
+    unsigned int dt, dx, dy;
+    if (!getVarint(&dt) || !getVarint(&dx) || !getVarint(&dy)) return false;
+    nextTime += dt;
+    nextPosition.x += unzigzag(dx);
+    nextPosition.y += unzigzag(dy);
+    read++;
+    return true;
+}
+
+/*
+ * Gets the next byte of the file, refilling the buffer when it 
+ * runs out.
+ */
+bool ghostPlayer::getByte(unsigned char* value) {
+    if (pos == used) {
+        used = fread(buffer, 1, GHOST_BUFFER, file);
+        pos = 0;
+        if (used <= 0) return false;
+    }
+    *value = buffer[pos++];
+    return true;
+}
+
+/*
+ * Reads a value written by ghostRecorder::putVarint.
+ */
+bool ghostPlayer::getVarint(unsigned int* value) {
+    *value = 0;
+    unsigned char byte;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (!getByte(&byte)) return false;
+        *value |= (unsigned int)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,94 @@
+/*
+ * ghostRun.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Records runs through a course and plays the best 
+ * one back as a ghost.  A run is a file with a short header and 
+ * one record per sample: the time and position since the last 
+ * sample, rounded to milliseconds and pixels and stored as 
+ * variable length integers.  Most records take three bytes.  The 
+ * recorder encodes into a fixed buffer and appends it to the file 
+ * when full, and the player reads the file through a small buffer, 
+ * so neither keeps a whole run in memory or allocates while a 
+ * game is being played.  A course's best run is kept under 
+ * GHOST_DIR at the course's path within courses/, so courses with 
+ * the same name in different directories keep their own.
+ *
+ */
+
+#ifndef _GHOST_RUN_H
+#define _GHOST_RUN_H
+
+#include "ofMain.h"
+#include "ofTypes.h"
+#include <stdio.h>
+
+#define GHOST_BUFFER 4096
+#define GHOST_HEADER 12
+#define GHOST_DIR string("ghosts")
+
+string getGhostPath(string coursePath);
+
+class ghostRecorder {
+
+    public:
+
+        ghostRecorder();
+        virtual ~ghostRecorder();
+
+        bool begin(string path);
+        void add(unsigned int time, ofPoint position);
+        bool finish(unsigned int duration);
+        void cancel();
+        bool isRecording();
+
+    private:
+
+        void putVarint(unsigned int value);
+        void flush();
+
+        FILE* file;
+        string path;
+        unsigned char buffer[GHOST_BUFFER];
+        int used;
+        unsigned int count, lastTime;
+        int lastX, lastY;
+};
+
+class ghostPlayer {
+
+    public:
+
+        ghostPlayer();
+        virtual ~ghostPlayer();
+
+        bool open(string path);
+        void close();
+        bool isOpen();
+        void rewind();
+        void update(unsigned int time);
+        bool readSample(unsigned int* time, ofPoint* position);
+
+        unsigned int getDuration();
+        ofPoint getPosition();
+
+    private:
+
+        bool readNext();
+        bool getByte(unsigned char* value);
+        bool getVarint(unsigned int* value);
+
+        FILE* file;
+        unsigned char buffer[GHOST_BUFFER];
+        int used, pos;
+        unsigned int duration, count, read;
+
+        unsigned int time, nextTime;
+        ofPoint position, nextPosition;
+        bool hasNext;
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * playerRun.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The rules of one player's attempt at a course. 
+ * Takes a position each frame, starts the run when it reaches the 
+ * start, keeps the trail, and ends the run when the trail hits an 
+ * edge or reaches the finish.  Knows nothing about the tracker or 
+ * the screen, so runs can also be played from recorded traces.
+ *
+ */
+
+#include "playerRun.h"
+#include "math.h"
+
+/*
+ * Default constructor.
+ */
+playerRun::playerRun() {
+    runCourse = 0;
+    field = 0;
+    drawing = false;
+    impacted = false;
+    checkMicros = 0;
+}
+
+/*
+ * Sets the course to run.  The collision field is optional; 
+ * without one every piece of the trail is swept against the 
+ * course's edges.
+ */
+void playerRun::setCourse(course* c, collisionField* f) {
+    runCourse = c;
+    field = f;
+    impacted = false;
+    reset();
+}
+
+/*
+ * Changes the collision field without touching the run, for when 
+ * a field of just a region is built again somewhere else.
+ */
+void playerRun::setField(collisionField* f) {
+    field = f;
+}
+
+/*
+ * Takes the player's position for this frame and returns what 
+ * happened.  Before the run starts, waits for the player to reach 
+ * the start.  During the run, adds the position to the trail and 
+ * checks it against the edges and the finish.  A run that crashed 
+ * or completed is reset, ready for the next one.
+ */
+int playerRun::update(ofPoint position) {
+    if (runCourse == 0) return RUN_WAITING;
+    if (!drawing) {
+        if (withinCircle(position, runCourse->start, IMP_NODE_SIZE)) {
+            drawing = true;
+            impacted = false;
+            return RUN_STARTED;
+        }
+        return RUN_WAITING;
+    }
+
+    line.add(position);
+    unsigned long long begin = ofGetElapsedTimeMicros();
+    bool out = outOfBounds();
+    checkMicros = ofGetElapsedTimeMicros() - begin;
+    if (out) {
+        reset();
+        return RUN_CRASHED;
+    }
+    if (withinCircle(position, runCourse->finish, IMP_NODE_SIZE)) {
+        reset();
+        return RUN_COMPLETE;
+    }
+    return RUN_DRAWING;
+}
+
+/*
+ * Ends the run and clears the trail.  Where the last run crashed 
+ * is kept.
+ */
+void playerRun::reset() {
+    drawing = false;
+    line.clear();
+}
+
+/*
+ * Returns if a run is going.
+ */
+bool playerRun::isDrawing() {
+    return drawing;
+}
+
+/*
+ * Returns if the last run crashed, and a new one hasn't started.
+ */
+bool playerRun::hasImpact() {
+    return impacted;
+}
+
+/*
+ * Returns where the last run crashed.
+ */
+ofPoint playerRun::getImpact() {
+    return impact;
+}
+
+/*
+ * Returns the trail of the current run.
+ */
+trail* playerRun::getTrail() {
+    return &line;
+}
+
+/*
+ * Returns how long the last collision check took, in microseconds.
+ */
+unsigned long playerRun::getCheckMicros() {
+    return checkMicros;
+}
+
+/*
+ * Returns if the newest piece of the line, from the previous 
+ * point to the latest one, comes within half of EDGE_WIDTH of 
+ * any edge of the course.  The whole path between the two points 
+ * is checked, not just where they are, so a fast stroke can't 
+ * skip over an edge.  Pieces that miss the collision field are 
+ * let through; the rest are swept against the nearby edges, and 
+ * the earliest point of impact is kept.
+ */
+bool playerRun::outOfBounds() {
+    if (line.getNumSamples() > 1) {
+        ofPoint latest = line.getLatest();
+        ofPoint previous = line.getPrevious();
+        if (field != 0 && !field->crosses(previous, latest)) return false;
+
+        float radius = EDGE_WIDTH / 2.0f;
+        float first = -1;
+        runCourse->getEdgesAlong(previous, latest, radius, nearbyEdges);
+        for (int i = 0; i < nearbyEdges.size(); i++) {
+            float t = nearbyEdges[i]->sweep(previous, latest, radius);
+            if (t >= 0 && (first < 0 || t < first)) first = t;
+        }
+        if (first >= 0) {
+            impact = previous + (latest - previous) * first;
+            impacted = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Returns whether or not the point position is within the 
+ * circle at point center with the given radius.
+ */
+bool playerRun::withinCircle(ofPoint position, ofPoint center, int radius) {
+    return pow((position.x - center.x), 2) + pow((position.y - center.y), 2) <= pow((double)radius, 2);
+}
@@ -0,0 +1,59 @@
+/*
+ * playerRun.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The rules of one player's attempt at a course. 
+ * Takes a position each frame, starts the run when it reaches the 
+ * start, keeps the trail, and ends the run when the trail hits an 
+ * edge or reaches the finish.  Knows nothing about the tracker or 
+ * the screen, so runs can also be played from recorded traces.
+ *
+ */
+
+#ifndef _PLAYER_RUN_H
+#define _PLAYER_RUN_H
+
+#include "ofMain.h"
+#include "ofTypes.h"
+#include "course.h"
+#include "collisionField.h"
+#include "trail.h"
+
+enum {RUN_WAITING, RUN_STARTED, RUN_DRAWING, RUN_CRASHED, RUN_COMPLETE};
+
+class playerRun {
+
+    public:
+
+        playerRun();
+
+        void setCourse(course* c, collisionField* f);
+        void setField(collisionField* f);
+        int update(ofPoint position);
+        void reset();
+
+        bool isDrawing();
+        bool hasImpact();
+        ofPoint getImpact();
+        trail* getTrail();
+        unsigned long getCheckMicros();
+
+    private:
+
+        bool outOfBounds();
+        bool withinCircle(ofPoint position, ofPoint center, int radius);
+
+        course* runCourse;
+        collisionField* field;
+        trail line;
+        vector<edge*> nearbyEdges;
+
+        bool drawing, impacted;
+        ofPoint impact;
+        unsigned long checkMicros;
+};
+
+#endif
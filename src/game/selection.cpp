@@ -110,6 +110,15 @@ void selection::update() {
     }
 }
 
+/*
+ * Returns how much tracking the screen needs.  Only the game
+ * uses the tracked position, the menu is driven by the mouse.
+ */
+int selection::getTrackingDemand() {
+    if (mode == PLAYING || (transition && nextMode == PLAYING)) return TRACK_POSITION;
+    return TRACK_NONE;
+}
+
 /*
  * Draws the screen.  If playing, draws the game.
  */
@@ -32,6 +32,7 @@ class selection : public ofBaseApp {
         void setup(tracker* t, ofBaseApp* p);
         void update();
         void draw();
+        int getTrackingDemand();
         void reset();
 
         void mousePressed(int x, int y, int button);
@@ -0,0 +1,280 @@
+/*
+ * trail.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The line a player draws during a game.  Points 
+ * are kept in a fixed ring, so a trail never allocates and never 
+ * grows past TRAIL_CAPACITY; the oldest points are dropped once 
+ * it is full.  Samples are simplified as they come in: the newest 
+ * point keeps sliding forward while every sample it passed stays 
+ * within TRAIL_TOLERANCE of a straight line, and is only fixed in 
+ * place once one doesn't.  The trail is drawn as one textured 
+ * triangle strip from a vertex buffer, and only the vertices of 
+ * points that changed are uploaded each frame.  Several trails 
+ * with the same image can be drawn together, setting up the 
+ * texture and vertex state once for all of them.
+ *
+ */
+
+#include "trail.h"
+
+/*
+ * Default constructor.  An empty trail.
+ */
+trail::trail() {
+    image = 0;
+    buffer = 0;
+    red = green = blue = 255;
+    uploadAll = true;
+    clear();
+}
+
+/*
+ * Destructor.  Frees the vertex buffer.
+ */
+trail::~trail() {
+    if (buffer != 0) glDeleteBuffers(1, &buffer);
+}
+
+/*
+ * Sets the image the trail is drawn with.
+ */
+void trail::setImage(ofImage* img) {
+    image = img;
+    texSize = img->getTextureReference().getCoordFromPercent(1, 1);
+    uploadAll = true;
+}
+
+/*
+ * Sets the color the trail's image is tinted with.
+ */
+void trail::setColor(int r, int g, int b) {
+    red = r;
+    green = g;
+    blue = b;
+}
+
+/*
+ * Empties the trail.
+ */
+void trail::clear() {
+    first = 0;
+    count = 0;
+    numSkipped = 0;
+    numSamples = 0;
+    numDirty = 0;
+}
+
+/*
+ * Adds a sample to the end of the trail.  If the last point and 
+ * every sample skipped since the one before it still fit on a line 
+ * to the new sample, the last point is moved there.  Otherwise the 
+ * last point stays and the sample starts a new segment.
+ */
+void trail::add(ofPoint sample) {
+    previous = latest;
+    latest = sample;
+    numSamples++;
+
+    if (count >= 2) {
+        int tip = (first + count - 1) % TRAIL_CAPACITY;
+        int anchor = (tip + TRAIL_CAPACITY - 1) % TRAIL_CAPACITY;
+        if (numSkipped < TRAIL_WINDOW) {
+            skipped[numSkipped++] = points[tip];
+            if (fitsLine(points[anchor], sample)) {
+                points[tip] = sample;
+                markDirty(tip);
+                markDirty(anchor);
+                return;
+            }
+        }
+    }
+    numSkipped = 0;
+    append(sample);
+}
+
+/*
+ * Draws the trail with a single call, after uploading whatever 
+ * changed since the last time.
+ */
+void trail::draw() {
+    trail* self = this;
+    drawAll(&self, 1);
+}
+
+/*
+ * Draws the given trails, which all use the image of the first one. 
+ * The texture and vertex state are set up once, then each trail 
+ * uploads what changed and draws its strip with a single call.
+ */
+void trail::drawAll(trail** trails, int numTrails) {
+    if (numTrails == 0 || trails[0]->image == 0) return;
+
+    ofImage* image = trails[0]->image;
+    image->getTextureReference().bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    for (int i = 0; i < numTrails; i++) {
+        if (trails[i]->count >= 2) trails[i]->drawStrip();
+    }
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    image->getTextureReference().unbind();
+}
+
+/*
+ * Uploads what changed and draws the strip.  The texture and vertex 
+ * state have to be set up already.
+ */
+void trail::drawStrip() {
+    upload();
+    ofSetColor(red, green, blue);
+    glVertexPointer(2, GL_FLOAT, sizeof(trailVertex), 0);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(trailVertex), (void*)(2 * sizeof(float)));
+    glDrawArrays(GL_TRIANGLE_STRIP, 2 * first, 2 * count);
+}
+
+/*
+ * Returns the number of points kept in the trail.
+ */
+int trail::size() {
+    return count;
+}
+
+/*
+ * Returns the number of samples added since the trail was cleared.
+ */
+int trail::getNumSamples() {
+    return numSamples;
+}
+
+/*
+ * Returns the sample added before the latest one.  Collision 
+ * checks use the raw samples, not the simplified points.
+ */
+ofPoint trail::getPrevious() {
+    return previous;
+}
+
+/*
+ * Returns the latest sample.
+ */
+ofPoint trail::getLatest() {
+    return latest;
+}
+
+/*
+ * Adds a point after the last one.  Drops the oldest point if the 
+ * ring is full.
+ */
+void trail::append(ofPoint p) {
+    if (count == TRAIL_CAPACITY) {
+        first = (first + 1) % TRAIL_CAPACITY;
+        count--;
+        markDirty(first);
+    }
+    int slot = (first + count) % TRAIL_CAPACITY;
+    points[slot] = p;
+    count++;
+    markDirty(slot);
+    if (count > 1) markDirty((slot + TRAIL_CAPACITY - 1) % TRAIL_CAPACITY);
+}
+
+/*
+ * Returns if every skipped sample is within TRAIL_TOLERANCE of 
+ * the segment from anchor to end.
+ */
+bool trail::fitsLine(ofPoint anchor, ofPoint end) {
+    edge line(&anchor, &end);
+    for (int i = 0; i < numSkipped; i++) {
+        if (line.distanceSquared(skipped[i]) > TRAIL_TOLERANCE * TRAIL_TOLERANCE) return false;
+    }
+    return true;
+}
+
+/*
+ * Marks the point in the given slot as needing its vertices 
+ * uploaded.  If too many points changed, everything is uploaded.
+ */
+void trail::markDirty(int slot) {
+    for (int i = 0; i < numDirty; i++) {
+        if (dirty[i] == slot) return;
+    }
+    if (numDirty == TRAIL_DIRTY) uploadAll = true;
+    else {dirty[numDirty++] = slot;}
+}
+
+/*
+ * Works out the two vertices of the point in the given slot.  They 
+ * sit half of EDGE_WIDTH to either side of the line, across the 
+ * direction from the point before to the point after.  Texture 
+ * coordinates alternate ends so every segment shows the whole image, 
+ * the same as drawing each edge.  The vertices are written twice, a 
+ * ring length apart, so the points from first on are always one run 
+ * in the buffer even after the ring wraps.
+ */
+void trail::buildVertices(int slot) {
+    int index = (slot - first + TRAIL_CAPACITY) % TRAIL_CAPACITY;
+    if (index >= count) return;
+
+    ofPoint p = points[slot];
+    ofPoint before = index > 0 ? points[(slot + TRAIL_CAPACITY - 1) % TRAIL_CAPACITY] : p;
+    ofPoint after = index < count - 1 ? points[(slot + 1) % TRAIL_CAPACITY] : p;
+    float dx = after.x - before.x;
+    float dy = after.y - before.y;
+    float len = sqrt(dx * dx + dy * dy);
+    float half = EDGE_WIDTH / 2.0f;
+    float nx = 0, ny = half;
+    if (len > 0) {
+        nx = -dy / len * half;
+        ny = dx / len * half;
+    }
+    float u = slot % 2 == 0 ? 0 : texSize.x;
+
+    trailVertex* v = &vertices[2 * slot];
+    v[0].x = p.x + nx;
+    v[0].y = p.y + ny;
+    v[0].u = u;
+    v[0].v = 0;
+    v[1].x = p.x - nx;
+    v[1].y = p.y - ny;
+    v[1].u = u;
+    v[1].v = texSize.y;
+    vertices[2 * (slot + TRAIL_CAPACITY)] = v[0];
+    vertices[2 * (slot + TRAIL_CAPACITY) + 1] = v[1];
+}
+
+/*
+ * Sends changed vertices to the vertex buffer, creating it the 
+ * first time, and leaves it bound.
+ */
+void trail::upload() {
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), 0, GL_DYNAMIC_DRAW);
+        uploadAll = true;
+    }
+    else {glBindBuffer(GL_ARRAY_BUFFER, buffer);}
+
+    if (uploadAll) {
+        for (int i = 0; i < count; i++) {
+            buildVertices((first + i) % TRAIL_CAPACITY);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    }
+    else {
+        for (int i = 0; i < numDirty; i++) {
+            int slot = dirty[i];
+            buildVertices(slot);
+            glBufferSubData(GL_ARRAY_BUFFER, 2 * slot * sizeof(trailVertex), 2 * sizeof(trailVertex), &vertices[2 * slot]);
+            glBufferSubData(GL_ARRAY_BUFFER, 2 * (slot + TRAIL_CAPACITY) * sizeof(trailVertex), 2 * sizeof(trailVertex), &vertices[2 * (slot + TRAIL_CAPACITY)]);
+        }
+    }
+    uploadAll = false;
+    numDirty = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * trail.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The line a player draws during a game.  Points 
+ * are kept in a fixed ring, so a trail never allocates and never 
+ * grows past TRAIL_CAPACITY; the oldest points are dropped once 
+ * it is full.  Samples are simplified as they come in: the newest 
+ * point keeps sliding forward while every sample it passed stays 
+ * within TRAIL_TOLERANCE of a straight line, and is only fixed in 
+ * place once one doesn't.  The trail is drawn as one textured 
+ * triangle strip from a vertex buffer, and only the vertices of 
+ * points that changed are uploaded each frame.  Several trails 
+ * with the same image can be drawn together, setting up the 
+ * texture and vertex state once for all of them.
+ *
+ */
+
+#ifndef _TRAIL_H
+#define _TRAIL_H
+
+#include "ofMain.h"
+#include "ofTypes.h"
+#include "course.h"
+
+#define TRAIL_CAPACITY 512
+#define TRAIL_WINDOW 64
+#define TRAIL_TOLERANCE 2.0f
+#define TRAIL_DIRTY 4
+
+class trail {
+
+    public:
+
+        trail();
+        virtual ~trail();
+
+        void setImage(ofImage* img);
+        void setColor(int r, int g, int b);
+        void clear();
+        void add(ofPoint sample);
+        void draw();
+        static void drawAll(trail** trails, int numTrails);
+
+        int size();
+        int getNumSamples();
+        ofPoint getPrevious();
+        ofPoint getLatest();
+
+    private:
+
+        /*
+         * One corner of the strip.  Each point has two, one on 
+         * either side of the line.
+         */
+        struct trailVertex {
+            float x, y, u, v;
+        };
+
+        void append(ofPoint p);
+        bool fitsLine(ofPoint anchor, ofPoint end);
+        void markDirty(int index);
+        void buildVertices(int index);
+        void upload();
+        void drawStrip();
+
+        ofPoint points[TRAIL_CAPACITY];
+        int first, count;
+
+        ofImage* image;
+        ofPoint texSize;
+        int red, green, blue;
+        trailVertex vertices[4 * TRAIL_CAPACITY];
+        GLuint buffer;
+        bool uploadAll;
+        int dirty[TRAIL_DIRTY];
+        int numDirty;
+
+        ofPoint skipped[TRAIL_WINDOW];
+        int numSkipped;
+
+        ofPoint previous, latest;
+        int numSamples;
+};
+
+#endif
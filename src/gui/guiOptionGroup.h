@@ -52,6 +52,16 @@ class guiOptionGroup {
             value = _value;
         }
 
+        /**
+         * Activates the option matching the current value, for 
+         * when the value was changed elsewhere.
+         */
+        void sync() {
+            for (list<guiOption*>::iterator it = options.begin(); it != options.end(); it++) {
+                (**it).setActive((**it).getValue() == *value);
+            }
+        }
+
     private:
 
         list<guiOption*> options;
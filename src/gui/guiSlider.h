@@ -48,9 +48,11 @@ class guiSlider {
         }
 
         /**
-         * Draws the slider.
+         * Draws the slider.  The value may have been changed 
+         * elsewhere, so the fill is worked out again.
          */
         void draw() {
+            updatePercent();
             ofSetColor(220, 220, 220);
             ofFill();
             ofRect(position.x, position.y, width, height);
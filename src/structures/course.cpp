@@ -7,7 +7,14 @@
  *
  * Description:  An object representing a course.  Consists 
  * of a start, finish, nodes, and edges.  Contains utility 
- * methods for adding, deleting, and updating nodes/edges.
+ * methods for adding, deleting, and updating nodes/edges, 
+ * and a spatial index to find them by position.  Every node's 
+ * edges are kept with it, so changing a node doesn't look at the 
+ * rest of the course.  The course can 
+ * be bigger than the screen.  What is in view, plus LAYER_MARGIN 
+ * on every side, is drawn into an offscreen layer whenever the 
+ * course changes or the view leaves the layer, and the layer is 
+ * drawn every frame.
  *
  */
 
@@ -15,17 +22,17 @@
 #include "math.h"
 
 /*
- * Default constructor.
+ * Default constructor.  Images are loaded the first time they are 
+ * needed, so a course can be built off the main thread.
  */
 course::course() {
     start = ofPoint(200, 400);
 	finish = ofPoint(ofGetWidth()-200, 400);
-	startImg.loadImage("images/start.png");
-	//startImg.resize(IMP_NODE_SIZE, IMP_NODE_SIZE);
-	finishImg.loadImage("images/finish.png");
-	//finishImg.resize(IMP_NODE_SIZE, IMP_NODE_SIZE);
-	nodeImg.loadImage("images/node_blue.png");
-	edgeImg.loadImage("images/edge_blue.png");
+	color = "blue";
+	imageColor = "";
+	layerChanged = true;
+	layerWidth = 0;
+	layerHeight = 0;
 }
 
 /*
@@ -36,9 +43,107 @@ course::~course() {
 }
 
 /*
- * Draws the current course.
+ * Draws the current course as seen from the top left of the 
+ * screen.
  */
 void course::draw() {
+	draw(ofPoint(0, 0));
+}
+
+/*
+ * Draws the part of the course in view, where view is the course 
+ * position at the top left of the screen.  Draws in course 
+ * coordinates, so the caller translates by -view first.  The layer 
+ * is only drawn again if the course or the window changed, or the 
+ * view moved out of it, otherwise this is a single image.
+ */
+void course::draw(ofPoint view) {
+	prepare(view);
+    ofSetRectMode(OF_RECTMODE_CORNER);
+	ofSetColor(255, 255, 255);
+	//the layer holds premultiplied colors
+	glPushAttrib(GL_COLOR_BUFFER_BIT);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	layer.draw(layerOrigin.x, layerOrigin.y);
+	glPopAttrib();
+
+	ofSetRectMode(OF_RECTMODE_CENTER);
+	ofSetLineWidth(EDGE_WIDTH);
+	ofFill();
+}
+
+/*
+ * Gets the course ready to draw from the given view: loads its 
+ * images and draws the layer if either is out of date.  Has to be 
+ * called on the main thread.
+ */
+void course::prepare(ofPoint view) {
+	loadImages();
+	if (layerChanged || start != layerStart || finish != layerFinish ||
+		layerWidth != ofGetWidth() || layerHeight != ofGetHeight() ||
+		view.x < layerOrigin.x || view.y < layerOrigin.y ||
+		view.x > layerOrigin.x + 2 * LAYER_MARGIN || view.y > layerOrigin.y + 2 * LAYER_MARGIN) {
+		renderLayer(view);
+	}
+}
+
+/*
+ * Loads the images for the course's color, if they aren't already.
+ */
+void course::loadImages() {
+	if (imageColor == color) return;
+	if (imageColor == "") {
+		startImg.loadImage("images/start.png");
+		//startImg.resize(IMP_NODE_SIZE, IMP_NODE_SIZE);
+		finishImg.loadImage("images/finish.png");
+		//finishImg.resize(IMP_NODE_SIZE, IMP_NODE_SIZE);
+	}
+	nodeImg.loadImage("images/node_" + color + ".png");
+	edgeImg.loadImage("images/edge_" + color + ".png");
+	imageColor = color;
+	layerChanged = true;
+}
+
+/*
+ * Draws the start, finish, nodes, and edges around the given view 
+ * into the layer.  Colors are blended as usual, but alpha is added 
+ * up instead of being multiplied by itself, so the layer ends up 
+ * with premultiplied colors.  Drawn with those, the images' soft 
+ * edges look the same as when drawn straight to the screen.
+ */
+void course::renderLayer(ofPoint view) {
+	if (layerWidth != ofGetWidth() || layerHeight != ofGetHeight()) {
+		layerWidth = ofGetWidth();
+		layerHeight = ofGetHeight();
+		layer.allocate(layerWidth + 2 * LAYER_MARGIN, layerHeight + 2 * LAYER_MARGIN, GL_RGBA);
+	}
+	layerOrigin = ofPoint(view.x - LAYER_MARGIN, view.y - LAYER_MARGIN);
+	layer.begin();
+	ofClear(0, 0, 0, 0);
+	ofPushStyle();
+	ofPushMatrix();
+	glPushAttrib(GL_COLOR_BUFFER_BIT);
+	glEnable(GL_BLEND);
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	ofTranslate(-layerOrigin.x, -layerOrigin.y, 0);
+	drawItems();
+	glPopAttrib();
+	ofPopMatrix();
+	ofPopStyle();
+	layer.end();
+
+	layerChanged = false;
+	layerStart = start;
+	layerFinish = finish;
+}
+
+/*
+ * Draws every part of the course that reaches into the layer, one 
+ * image at a time.  The index finds them, so a big course costs no 
+ * more than the part of it in view.
+ */
+void course::drawItems() {
     ofSetRectMode(OF_RECTMODE_CENTER);
 	ofSetLineWidth(EDGE_WIDTH);
 	ofFill();
@@ -53,16 +158,21 @@ void course::draw() {
 	startImg.draw(start.x, start.y);
 	finishImg.draw(finish.x, finish.y);
  
+	float left = layerOrigin.x - EDGE_WIDTH;
+	float top = layerOrigin.y - EDGE_WIDTH;
+	float right = layerOrigin.x + layerWidth + 2 * LAYER_MARGIN + EDGE_WIDTH;
+	float bottom = layerOrigin.y + layerHeight + 2 * LAYER_MARGIN + EDGE_WIDTH;
+
     //Draw nodes
     ofSetColor(255, 255, 255);
-	for (list<ofPoint>::iterator it = nodes.begin(); it != nodes.end(); it++) {
-		//ofRect(it->x, it->y, NODE_SIZE, NODE_SIZE);
-		nodeImg.draw(it->x, it->y, NODE_SIZE, NODE_SIZE);
+	grid.getNodesIn(left, top, right, bottom, visibleNodes);
+	for (int i = 0; i < visibleNodes.size(); i++) {
+		nodeImg.draw(visibleNodes[i]->x, visibleNodes[i]->y, NODE_SIZE, NODE_SIZE);
 	}
 	//Draw edges
-	for (list<edge>::iterator it = edges.begin(); it != edges.end(); it++) {
-		//ofLine(it->p1->x, it->p1->y, it->p2->x, it->p2->y);
-		it->draw(&edgeImg);
+	grid.getEdgesIn(left, top, right, bottom, visibleEdges);
+	for (int i = 0; i < visibleEdges.size(); i++) {
+		visibleEdges[i]->draw(&edgeImg);
 	}
 }
 
@@ -70,7 +180,10 @@ void course::draw() {
  * Adds the given node to the course's node list.
  */
 ofPoint* course::addNode(ofPoint node) {
+	layerChanged = true;
 	nodes.push_back(node);
+	nodeEntries[&nodes.back()] = --nodes.end();
+	grid.addNode(&nodes.back());
 	//std::cout<<"# nodes "<<nodes.size()<<'\n';
     return &nodes.back();
 }
@@ -79,12 +192,14 @@ ofPoint* course::addNode(ofPoint node) {
  * Deletes the node referenced by the given pointer.
  */
 void course::deleteNode(ofPoint* node) {
+	layerChanged = true;
 	deleteAssocEdges(node);
-    int index = getNodeIndex(node);
-    list<ofPoint>::iterator it = nodes.begin();
-	if (index >= 0) {
-		advance(it, index);
-		nodes.erase(it);
+	nodeEdges.erase(node);
+	map<ofPoint*, list<ofPoint>::iterator>::iterator entry = nodeEntries.find(node);
+	if (entry != nodeEntries.end()) {
+		grid.removeNode(node);
+		nodes.erase(entry->second);
+		nodeEntries.erase(entry);
 	}
 	//std::cout<<"# nodes "<<nodes.size()<<'\n';
 }
@@ -93,8 +208,10 @@ void course::deleteNode(ofPoint* node) {
  * Updates the given node with the position (x, y)
  */
 ofPoint* course::updateNode(ofPoint* node, int x, int y) {
+	layerChanged = true;
     node->x = x;
 	node->y = y;
+	grid.updateNode(node);
 	updateAssocEdges(node);
     return node;
 } 
@@ -139,7 +256,7 @@ int course::getNodeIndex(ofPoint* node) {
 ofPoint* course::mergeNodes(ofPoint* base, ofPoint* mergee) {
     mergeEdges(base, mergee);
     deleteNode(mergee);
-	removeDuplicateEdges();
+	removeDuplicateEdges(base);
 	updateAssocEdges(base);
 	return base;
 }
@@ -148,8 +265,12 @@ ofPoint* course::mergeNodes(ofPoint* base, ofPoint* mergee) {
  * Adds an edge between the two referenced nodes.
  */
 void course::addEdge(ofPoint* p1, ofPoint* p2) {
+	layerChanged = true;
     edge newEdge = edge(p1, p2);
 	edges.push_back(newEdge);
+	edgeEntries[&edges.back()] = --edges.end();
+	linkEdge(&edges.back());
+	grid.addEdge(&edges.back());
 	//std::cout<<"# edges "<<edges.size()<<'\n';
 }
 
@@ -164,12 +285,14 @@ void course::deleteAssocEdges(ofPoint* node) {
 }
 
 /*
- * Updates all edges associated with the given node.
+ * Updates all edges associated with the given node, and where 
+ * they are in the index.
  */
 void course::updateAssocEdges(ofPoint* node) {
     vector<edge*> assoc = getAssocEdges(node);
 	for (int i = 0; i < assoc.size(); i++) {
 		assoc[i]->update();
+		grid.updateEdge(assoc[i]);
 	}
 }
 
@@ -177,22 +300,22 @@ void course::updateAssocEdges(ofPoint* node) {
  * Gets all edges associated with the given node.
  */
 vector<edge*> course::getAssocEdges(ofPoint* node) {
-	vector<edge*> assoc;
-	for (list<edge>::iterator it = edges.begin(); it != edges.end(); it++) {
-		if (it->p1 == node || it->p2 == node) assoc.push_back(&*it);
-	}
-	return assoc;
+	map<ofPoint*, vector<edge*> >::iterator it = nodeEdges.find(node);
+	if (it == nodeEdges.end()) return vector<edge*>();
+	return it->second;
 }
 
 /*
  * Deletes the referenced edge from the edge list.
  */
 void course::deleteEdge(edge* e) {
-    int index = getEdgeIndex(e);
-	list<edge>::iterator it = edges.begin();
-	if (index >= 0) {
-		advance(it, index);
-		edges.erase(it);
+	layerChanged = true;
+	map<edge*, list<edge>::iterator>::iterator entry = edgeEntries.find(e);
+	if (entry != edgeEntries.end()) {
+		unlinkEdge(e);
+		grid.removeEdge(e);
+		edges.erase(entry->second);
+		edgeEntries.erase(entry);
 	}
 	//std::cout<<"# edges "<<edges.size()<<'\n';
 }
@@ -223,32 +346,35 @@ int course::getEdgeIndex(edge* e) {
  * reference to mergee replaces mergee with base.
  */
 ofPoint* course::mergeEdges(ofPoint* base, ofPoint* mergee) {
-    for (list<edge>::iterator it = edges.begin(); it != edges.end(); it++) {
-		if (it->p1 == mergee) it->p1 = base;
-		if (it->p2 == mergee) it->p2 = base;
+	layerChanged = true;
+	vector<edge*> assoc = getAssocEdges(mergee);
+	for (int i = 0; i < assoc.size(); i++) {
+		edge* e = assoc[i];
+		unlinkEdge(e);
+		if (e->p1 == mergee) e->p1 = base;
+		if (e->p2 == mergee) e->p2 = base;
+		linkEdge(e);
+		grid.updateEdge(e);
 	}
     return base;
 }
 
 /*
- * Removes duplicate edges from the edge list.  
- * Really a pretty backwards way of doing it. I don't like it 
- * but iterators don't allow simple arithmetic.
+ * Removes duplicate edges among those of the given node.  Only 
+ * an edge that was just made or moved onto the node can be a 
+ * duplicate, so the rest of the course isn't looked at.
  */
-void course::removeDuplicateEdges() {
+void course::removeDuplicateEdges(ofPoint* node) {
+    vector<edge*> assoc = getAssocEdges(node);
     vector<edge*> duplicates;
-	int count = 0;
-	for (list<edge>::iterator it = edges.begin(); it != edges.end(); it++) {
-		for (list<edge>::iterator er = it; er != edges.end(); er++) {
-			if (it->p1 == er->p1 && it->p2 == er->p2 || 
-				it->p1 == er->p2 && it->p2 == er->p1) {
-				count++;
-				if (count > 1) {
-				    duplicates.push_back(&*it);
-				}
+	for (int i = 0; i < assoc.size(); i++) {
+		for (int j = i + 1; j < assoc.size(); j++) {
+			if (assoc[i]->p1 == assoc[j]->p1 && assoc[i]->p2 == assoc[j]->p2 || 
+				assoc[i]->p1 == assoc[j]->p2 && assoc[i]->p2 == assoc[j]->p1) {
+				duplicates.push_back(assoc[i]);
+				break;
 			}
 		}
-		count = 0;
 	}
 	for (int i = 0; i < duplicates.size(); i++) {
         deleteEdge(duplicates[i]);  
@@ -261,11 +387,18 @@ void course::removeDuplicateEdges() {
  * edges {a, c} and {c, b}. 
  */
 ofPoint* course::addIntermediateNode(edge* e, ofPoint* node) {
+	layerChanged = true;
     edge newEdge = edge(node, e->p2);
 	edges.push_back(newEdge);
+	edgeEntries[&edges.back()] = --edges.end();
+	linkEdge(&edges.back());
+	grid.addEdge(&edges.back());
+	unlinkEdge(e);
 	e->p2 = node;
 	e->update();
-	removeDuplicateEdges();
+	linkEdge(e);
+	grid.updateEdge(e);
+	removeDuplicateEdges(node);
 	return node;
 }
 
@@ -283,26 +416,120 @@ void course::setFinish(ofPoint pos) {
     finish = pos;
 }
 
+/*
+ * Returns the node closest to (x, y) that is less than bound away 
+ * on both axes, or null if there is none.  The start and finish 
+ * are not nodes, and the ignored node is never returned.
+ */
+ofPoint* course::getNearestNode(float x, float y, float bound, ofPoint* ignore) {
+	return grid.getNearestNode(x, y, bound, ignore);
+}
+
+/*
+ * Gets the edges whose bounds, grown by bound, contain (x, y).
+ */
+void course::getEdgesNear(float x, float y, float bound, vector<edge*>& result) {
+	grid.getEdgesNear(x, y, bound, result);
+}
+
+/*
+ * Gets the edges whose bounds, grown by bound, overlap those of 
+ * the segment from a to b.
+ */
+void course::getEdgesAlong(ofPoint a, ofPoint b, float bound, vector<edge*>& result) {
+	grid.getEdgesAlong(a, b, bound, result);
+}
+
+/*
+ * Gets the edges whose bounds overlap the given bounds.
+ */
+void course::getEdgesIn(ofRectangle bounds, vector<edge*>& result) {
+	grid.getEdgesIn(bounds.x, bounds.y, bounds.x + bounds.width, bounds.y + bounds.height, result);
+}
+
+/*
+ * Returns the bounds of the start, finish, and nodes.
+ */
+ofRectangle course::getBounds() {
+	float minX = min(start.x, finish.x), maxX = max(start.x, finish.x);
+	float minY = min(start.y, finish.y), maxY = max(start.y, finish.y);
+	for (list<ofPoint>::iterator it = nodes.begin(); it != nodes.end(); it++) {
+		minX = min(minX, it->x);
+		maxX = max(maxX, it->x);
+		minY = min(minY, it->y);
+		maxY = max(maxY, it->y);
+	}
+	return ofRectangle(minX, minY, maxX - minX, maxY - minY);
+}
+
 /*
  * Clears the node and edge lists.
  */
 void course::clearCourse() {
+	layerChanged = true;
     nodes.clear();
 	edges.clear();
+	grid.clear();
+	nodeEdges.clear();
+	nodeEntries.clear();
+	edgeEntries.clear();
 }
 
 /*
- * Sets the courses color.
+ * Indexes every node and edge again, after the lists were 
+ * replaced.
  */
-void course::setColor(string color) {
-	nodeImg.loadImage("images/node_" + color + ".png");
-    edgeImg.loadImage("images/edge_" + color + ".png");
+void course::rebuildIndex() {
+	grid.clear();
+	nodeEdges.clear();
+	nodeEntries.clear();
+	edgeEntries.clear();
+	for (list<ofPoint>::iterator it = nodes.begin(); it != nodes.end(); it++) {
+		nodeEntries[&*it] = it;
+		grid.addNode(&*it);
+	}
+	for (list<edge>::iterator it = edges.begin(); it != edges.end(); it++) {
+		edgeEntries[&*it] = it;
+		linkEdge(&*it);
+		grid.addEdge(&*it);
+	}
+}
+
+/*
+ * Lists an edge with both of its nodes.
+ */
+void course::linkEdge(edge* e) {
+	nodeEdges[e->p1].push_back(e);
+	if (e->p2 != e->p1) nodeEdges[e->p2].push_back(e);
+}
+
+/*
+ * Takes an edge off the lists of both of its nodes.
+ */
+void course::unlinkEdge(edge* e) {
+	ofPoint* ends[2] = {e->p1, e->p2};
+	for (int i = 0; i < 2; i++) {
+		map<ofPoint*, vector<edge*> >::iterator it = nodeEdges.find(ends[i]);
+		if (it == nodeEdges.end()) continue;
+		vector<edge*>::iterator found = find(it->second.begin(), it->second.end(), e);
+		if (found != it->second.end()) it->second.erase(found);
+	}
+}
+
+/*
+ * Sets the courses color.  The images for it are loaded when the 
+ * course is next drawn.
+ */
+void course::setColor(string _color) {
+	color = _color;
+	layerChanged = true;
 }
 
 /*
  * Returns a pointer to the node image.
  */
 ofImage* course::getNodeImage() {
+	loadImages();
     return &nodeImg;
 }
 
@@ -310,5 +537,6 @@ ofImage* course::getNodeImage() {
  * Returns a pointer to the edge image.
  */
 ofImage* course::getEdgeImage() {
+	loadImages();
     return &edgeImg;
 }
@@ -7,7 +7,14 @@
  *
  * Description:  An object representing a course.  Consists 
  * of a start, finish, nodes, and edges.  Contains utility 
- * methods for adding, deleting, and updating nodes/edges.
+ * methods for adding, deleting, and updating nodes/edges, 
+ * and a spatial index to find them by position.  Every node's 
+ * edges are kept with it, so changing a node doesn't look at the 
+ * rest of the course.  The course can 
+ * be bigger than the screen.  What is in view, plus LAYER_MARGIN 
+ * on every side, is drawn into an offscreen layer whenever the 
+ * course changes or the view leaves the layer, and the layer is 
+ * drawn every frame.
  *
  */
 
@@ -17,10 +24,12 @@
 #define NODE_SIZE 12
 #define IMP_NODE_SIZE 40
 #define EDGE_WIDTH 20
+#define LAYER_MARGIN 256
 
 #include "ofTypes.h"
 #include "ofMain.h"
 #include "edge.h"
+#include "courseIndex.h"
 
 class course {
 
@@ -34,10 +43,14 @@ class course {
             finish = course.finish;
             nodes = course.nodes;
             edges = course.edges;
+            rebuildIndex();
+            layerChanged = true;
             return *this;
         }
         
         void draw();
+        void draw(ofPoint view);
+        void prepare(ofPoint view);
         
         ofPoint* addNode(ofPoint node);
         void deleteNode(ofPoint* node);
@@ -55,9 +68,15 @@ class course {
         edge* getEdgeAt(int index);
         int getEdgeIndex(edge* e);
         ofPoint* mergeEdges(ofPoint* base, ofPoint* mergee);
-        void removeDuplicateEdges();
+        void removeDuplicateEdges(ofPoint* node);
         ofPoint* addIntermediateNode(edge* e, ofPoint* node);
 
+        ofPoint* getNearestNode(float x, float y, float bound, ofPoint* ignore);
+        void getEdgesNear(float x, float y, float bound, vector<edge*>& result);
+        void getEdgesAlong(ofPoint a, ofPoint b, float bound, vector<edge*>& result);
+        void getEdgesIn(ofRectangle bounds, vector<edge*>& result);
+        ofRectangle getBounds();
+
         void clearCourse();
 
         ofImage* getNodeImage();
@@ -73,6 +92,26 @@ class course {
 
     private:
 
+        void rebuildIndex();
+        void linkEdge(edge* e);
+        void unlinkEdge(edge* e);
+        void loadImages();
+        void renderLayer(ofPoint view);
+        void drawItems();
+
+        courseIndex grid;
+        map<ofPoint*, vector<edge*> > nodeEdges;
+        map<ofPoint*, list<ofPoint>::iterator> nodeEntries;
+        map<edge*, list<edge>::iterator> edgeEntries;
+        vector<ofPoint*> visibleNodes;
+        vector<edge*> visibleEdges;
+
+        ofFbo layer;
+        bool layerChanged;
+        int layerWidth, layerHeight;
+        ofPoint layerOrigin, layerStart, layerFinish;
+
+        string color, imageColor;
         ofImage startImg;
         ofImage finishImg;
         ofImage nodeImg;
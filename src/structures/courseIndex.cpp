@@ -0,0 +1,317 @@
+/*
+ * courseIndex.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A spatial index of a course's nodes and edges. 
+ * The plane is divided into square cells.  Every node is listed 
+ * in the cell it is in, and every edge in the cells it passes 
+ * through, with half of EDGE_WIDTH around it.  Cells are hashed 
+ * into buckets, so the course can be any size, and the number of 
+ * buckets grows with what is listed, so they stay short.  Queries 
+ * only look at the cells around what they ask about, instead of 
+ * every node or edge of the course.  The course keeps the index up 
+ * to date as it changes.
+ *
+ */
+
+#include "courseIndex.h"
+#include "course.h"
+
+/*
+ * Default constructor.  An empty index.
+ */
+courseIndex::courseIndex() {
+    clear();
+}
+
+/*
+ * Removes everything from the index.
+ */
+void courseIndex::clear() {
+    nodeBuckets.assign(INDEX_MIN_BUCKETS, vector<ofPoint*>());
+    edgeBuckets.assign(INDEX_MIN_BUCKETS, vector<edge*>());
+    nodeCells.clear();
+    edgeCells.clear();
+    numEntries = 0;
+}
+
+/*
+ * Adds a node to the cell it is in.
+ */
+void courseIndex::addNode(ofPoint* node) {
+    if (numEntries >= nodeBuckets.size() * INDEX_BUCKET_LOAD) grow();
+    cellRange cells = getCells(node->x, node->y, node->x, node->y);
+    nodeBuckets[getBucket(cells.left, cells.top)].push_back(node);
+    nodeCells[node] = cells;
+    numEntries++;
+}
+
+/*
+ * Removes a node from the cell it was added to.
+ */
+void courseIndex::removeNode(ofPoint* node) {
+    map<ofPoint*, cellRange>::iterator it = nodeCells.find(node);
+    if (it == nodeCells.end()) return;
+    vector<ofPoint*>& bucket = nodeBuckets[getBucket(it->second.left, it->second.top)];
+    bucket.erase(find(bucket.begin(), bucket.end(), node));
+    nodeCells.erase(it);
+    numEntries--;
+}
+
+/*
+ * Moves a node to the cell it is in now.  Nodes that aren't in 
+ * the index, like the start and finish, are left out.
+ */
+void courseIndex::updateNode(ofPoint* node) {
+    if (nodeCells.find(node) == nodeCells.end()) return;
+    removeNode(node);
+    addNode(node);
+}
+
+/*
+ * Adds an edge to every cell it passes through.
+ */
+void courseIndex::addEdge(edge* e) {
+    if (numEntries >= edgeBuckets.size() * INDEX_BUCKET_LOAD) grow();
+    vector<int>& buckets = edgeCells[e];
+    getEdgeBuckets(e, buckets);
+    for (int i = 0; i < buckets.size(); i++) {
+        edgeBuckets[buckets[i]].push_back(e);
+    }
+    numEntries += buckets.size();
+}
+
+/*
+ * Removes an edge from the cells it was added to.
+ */
+void courseIndex::removeEdge(edge* e) {
+    map<edge*, vector<int> >::iterator it = edgeCells.find(e);
+    if (it == edgeCells.end()) return;
+    vector<int>& buckets = it->second;
+    for (int i = 0; i < buckets.size(); i++) {
+        vector<edge*>& bucket = edgeBuckets[buckets[i]];
+        vector<edge*>::iterator found = find(bucket.begin(), bucket.end(), e);
+        if (found != bucket.end()) bucket.erase(found);
+    }
+    numEntries -= buckets.size();
+    edgeCells.erase(it);
+}
+
+/*
+ * Moves an edge to the cells it covers now, after one of its 
+ * nodes moved or was replaced.
+ */
+void courseIndex::updateEdge(edge* e) {
+    removeEdge(e);
+    addEdge(e);
+}
+
+/*
+ * Returns the node closest to (x, y) that is less than bound away 
+ * on both axes, or null if there is none.  The ignored node is 
+ * never returned.
+ */
+ofPoint* courseIndex::getNearestNode(float x, float y, float bound, ofPoint* ignore) {
+    cellRange cells = getCells(x - bound, y - bound, x + bound, y + bound);
+    ofPoint* nearest = 0;
+    float nearestDist = 0;
+    for (int cy = cells.top; cy <= cells.bottom; cy++) {
+        for (int cx = cells.left; cx <= cells.right; cx++) {
+            vector<ofPoint*>& bucket = nodeBuckets[getBucket(cx, cy)];
+            for (int i = 0; i < bucket.size(); i++) {
+                ofPoint* node = bucket[i];
+                if (node == ignore || fabs(node->x - x) >= bound || fabs(node->y - y) >= bound) continue;
+                float dist = (node->x - x) * (node->x - x) + (node->y - y) * (node->y - y);
+                if (nearest == 0 || dist < nearestDist) {
+                    nearest = node;
+                    nearestDist = dist;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+/*
+ * Gets the edges whose bounds, grown by bound, contain (x, y). 
+ * Those are the only edges that can be within bound of the point.
+ */
+void courseIndex::getEdgesNear(float x, float y, float bound, vector<edge*>& result) {
+    result.clear();
+    collectEdges(getCells(x - bound, y - bound, x + bound, y + bound), result);
+    int kept = 0;
+    for (int i = 0; i < result.size(); i++) {
+        if (result[i]->withinBounds(x, y, bound)) result[kept++] = result[i];
+    }
+    result.resize(kept);
+}
+
+/*
+ * Gets the edges whose bounds, grown by bound, overlap those of 
+ * the segment from a to b.  Those are the only edges that can 
+ * come within bound of the segment.
+ */
+void courseIndex::getEdgesAlong(ofPoint a, ofPoint b, float bound, vector<edge*>& result) {
+    getEdgesIn(min(a.x, b.x) - bound, min(a.y, b.y) - bound,
+               max(a.x, b.x) + bound, max(a.y, b.y) + bound, result);
+}
+
+/*
+ * Gets the nodes inside the given bounds.  Bounds covering more 
+ * cells than there are buckets just look at every bucket once.
+ */
+void courseIndex::getNodesIn(float left, float top, float right, float bottom, vector<ofPoint*>& result) {
+    result.clear();
+    cellRange cells = getCells(left, top, right, bottom);
+    if (isWide(cells)) {
+        for (int i = 0; i < nodeBuckets.size(); i++) {
+            result.insert(result.end(), nodeBuckets[i].begin(), nodeBuckets[i].end());
+        }
+    }
+    else {
+        for (int cy = cells.top; cy <= cells.bottom; cy++) {
+            for (int cx = cells.left; cx <= cells.right; cx++) {
+                vector<ofPoint*>& bucket = nodeBuckets[getBucket(cx, cy)];
+                result.insert(result.end(), bucket.begin(), bucket.end());
+            }
+        }
+        //far apart cells can share a bucket
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+    }
+    int kept = 0;
+    for (int i = 0; i < result.size(); i++) {
+        ofPoint* node = result[i];
+        if (node->x >= left && node->x <= right && node->y >= top && node->y <= bottom) result[kept++] = node;
+    }
+    result.resize(kept);
+}
+
+/*
+ * Gets the edges whose bounds overlap the given bounds.
+ */
+void courseIndex::getEdgesIn(float left, float top, float right, float bottom, vector<edge*>& result) {
+    result.clear();
+    collectEdges(getCells(left, top, right, bottom), result);
+    int kept = 0;
+    for (int i = 0; i < result.size(); i++) {
+        edge* e = result[i];
+        if (max(e->p1->x, e->p2->x) >= left && min(e->p1->x, e->p2->x) <= right &&
+            max(e->p1->y, e->p2->y) >= top && min(e->p1->y, e->p2->y) <= bottom) {
+            result[kept++] = e;
+        }
+    }
+    result.resize(kept);
+}
+
+/*
+ * Gets every edge listed in the given cells, each once.
+ */
+void courseIndex::collectEdges(cellRange cells, vector<edge*>& result) {
+    if (isWide(cells)) {
+        for (int i = 0; i < edgeBuckets.size(); i++) {
+            result.insert(result.end(), edgeBuckets[i].begin(), edgeBuckets[i].end());
+        }
+    }
+    else {
+        for (int y = cells.top; y <= cells.bottom; y++) {
+            for (int x = cells.left; x <= cells.right; x++) {
+                vector<edge*>& bucket = edgeBuckets[getBucket(x, y)];
+                result.insert(result.end(), bucket.begin(), bucket.end());
+            }
+        }
+    }
+    sort(result.begin(), result.end());
+    result.erase(unique(result.begin(), result.end()), result.end());
+}
+
+/*
+ * Returns the cells covered by the given bounds.
+ */
+courseIndex::cellRange courseIndex::getCells(float left, float top, float right, float bottom) {
+    cellRange cells;
+    cells.left = (int)floor(left / INDEX_CELL_SIZE);
+    cells.top = (int)floor(top / INDEX_CELL_SIZE);
+    cells.right = (int)floor(right / INDEX_CELL_SIZE);
+    cells.bottom = (int)floor(bottom / INDEX_CELL_SIZE);
+    return cells;
+}
+
+/*
+ * Returns if the given cells are more than there are buckets.
+ */
+bool courseIndex::isWide(cellRange cells) {
+    return (double)(cells.right - cells.left + 1) * (cells.bottom - cells.top + 1) >= edgeBuckets.size();
+}
+
+/*
+ * Returns the bucket a cell is hashed into.  Far apart cells 
+ * may share a bucket; queries check the actual positions.
+ */
+int courseIndex::getBucket(int x, int y) {
+    unsigned int hash = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    return hash % edgeBuckets.size();
+}
+
+/*
+ * Gets the buckets of the cells that come within half of EDGE_WIDTH 
+ * of the edge, each once.  The cells are found a row at a time: 
+ * the part of the edge that reaches into a row, grown by the width, 
+ * covers a run of cells in it.  A long edge is only listed along 
+ * its length, not in every cell of its bounds.
+ */
+void courseIndex::getEdgeBuckets(edge* e, vector<int>& buckets) {
+    buckets.clear();
+    float margin = EDGE_WIDTH / 2.0f;
+    ofPoint a = *e->p1, b = *e->p2;
+    if (b.y < a.y) swap(a, b);
+    int top = (int)floor((a.y - margin) / INDEX_CELL_SIZE);
+    int bottom = (int)floor((b.y + margin) / INDEX_CELL_SIZE);
+    for (int cy = top; cy <= bottom; cy++) {
+        float y0 = max(a.y, (float)cy * INDEX_CELL_SIZE - margin);
+        float y1 = min(b.y, (float)(cy + 1) * INDEX_CELL_SIZE + margin);
+        float x0 = a.x, x1 = b.x;
+        if (b.y > a.y) {
+            x0 = a.x + (b.x - a.x) * (y0 - a.y) / (b.y - a.y);
+            x1 = a.x + (b.x - a.x) * (y1 - a.y) / (b.y - a.y);
+        }
+        if (x1 < x0) swap(x0, x1);
+        int left = (int)floor((x0 - margin) / INDEX_CELL_SIZE);
+        int right = (int)floor((x1 + margin) / INDEX_CELL_SIZE);
+        for (int cx = left; cx <= right; cx++) {
+            buckets.push_back(getBucket(cx, cy));
+        }
+    }
+    sort(buckets.begin(), buckets.end());
+    buckets.erase(unique(buckets.begin(), buckets.end()), buckets.end());
+}
+
+/*
+ * Doubles the number of buckets and lists everything again, once 
+ * there are INDEX_BUCKET_LOAD entries for every bucket.
+ */
+void courseIndex::grow() {
+    vector<ofPoint*> allNodes;
+    vector<edge*> allEdges;
+    for (map<ofPoint*, cellRange>::iterator it = nodeCells.begin(); it != nodeCells.end(); it++) {
+        allNodes.push_back(it->first);
+    }
+    for (map<edge*, vector<int> >::iterator it = edgeCells.begin(); it != edgeCells.end(); it++) {
+        allEdges.push_back(it->first);
+    }
+    int size = edgeBuckets.size() * 2;
+    nodeBuckets.assign(size, vector<ofPoint*>());
+    edgeBuckets.assign(size, vector<edge*>());
+    nodeCells.clear();
+    edgeCells.clear();
+    numEntries = 0;
+    for (int i = 0; i < allNodes.size(); i++) {
+        addNode(allNodes[i]);
+    }
+    for (int i = 0; i < allEdges.size(); i++) {
+        addEdge(allEdges[i]);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * courseIndex.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A spatial index of a course's nodes and edges. 
+ * The plane is divided into square cells.  Every node is listed 
+ * in the cell it is in, and every edge in the cells it passes 
+ * through, with half of EDGE_WIDTH around it.  Cells are hashed 
+ * into buckets, so the course can be any size, and the number of 
+ * buckets grows with what is listed, so they stay short.  Queries 
+ * only look at the cells around what they ask about, instead of 
+ * every node or edge of the course.  The course keeps the index up 
+ * to date as it changes.
+ *
+ */
+
+#ifndef _COURSE_INDEX_H
+#define _COURSE_INDEX_H
+
+#include "ofTypes.h"
+
+#define INDEX_CELL_SIZE 64
+#define INDEX_MIN_BUCKETS 1024
+#define INDEX_BUCKET_LOAD 2
+
+class edge;
+
+class courseIndex {
+
+    public:
+
+        courseIndex();
+
+        void clear();
+
+        void addNode(ofPoint* node);
+        void removeNode(ofPoint* node);
+        void updateNode(ofPoint* node);
+        void addEdge(edge* e);
+        void removeEdge(edge* e);
+        void updateEdge(edge* e);
+
+        ofPoint* getNearestNode(float x, float y, float bound, ofPoint* ignore);
+        void getEdgesNear(float x, float y, float bound, vector<edge*>& result);
+        void getEdgesAlong(ofPoint a, ofPoint b, float bound, vector<edge*>& result);
+        void getNodesIn(float left, float top, float right, float bottom, vector<ofPoint*>& result);
+        void getEdgesIn(float left, float top, float right, float bottom, vector<edge*>& result);
+
+    private:
+
+        /*
+         * The cells something is listed in.
+         */
+        struct cellRange {
+            int left, top, right, bottom;
+        };
+
+        static cellRange getCells(float left, float top, float right, float bottom);
+        bool isWide(cellRange cells);
+        int getBucket(int x, int y);
+        void getEdgeBuckets(edge* e, vector<int>& buckets);
+        void collectEdges(cellRange cells, vector<edge*>& result);
+        void grow();
+
+        vector< vector<ofPoint*> > nodeBuckets;
+        vector< vector<edge*> > edgeBuckets;
+        map<ofPoint*, cellRange> nodeCells;
+        map<edge*, vector<int> > edgeCells;
+        int numEntries;
+};
+
+#endif
@@ -6,8 +6,10 @@
  * Project: Flash Track
  *
  * Description:  An object representing an edge.  Contains 
- * pointers to two nodes, and information about the equation of 
- * the line.
+ * pointers to two nodes, its length and angle, and the geometry 
+ * tests done against it.  The tests only use orientations and 
+ * projections, so vertical and horizontal edges need no special 
+ * cases.
  *
  */
 
@@ -27,10 +29,6 @@ class edge {
         edge() {
             p1 = 0;
             p2 = 0;
-            xAxis = false;
-            yAxis = false;
-            slope = 0;
-            yIntercept = 0;
             length = 0;
             theta = 0;
         }
@@ -46,9 +44,8 @@ class edge {
 
         /*
          * Updates the line information of the edge.
-         * Puts the point with the lowest x as p1, find the slope, 
-         * yIntercept, whether or not its a hor/ver line, its theta,
-         * and length.
+         * Puts the point with the lowest x as p1, and finds its 
+         * theta and length.
          */
         edge* update() {
             if (p2->x < p1->x) {
@@ -58,18 +55,9 @@ class edge {
             }
             double xDif = p2->x - p1->x;
             double yDif = p2->y - p1->y;
-            
-            slope = (yDif) / (xDif);
-            yIntercept = p1->y - (slope * p1->x);
-            if (abs(xDif) < NODE_SIZE / 2) yAxis = true;
-            else {yAxis = false;}
-            if (abs(yDif) < NODE_SIZE / 2) xAxis = true;
-            else {xAxis = false;}
-            length = sqrt(pow(xDif, 2) + pow(yDif, 2));
 
-            theta = atan(abs(yDif) / xDif) * 180 / PI;
-            if (p2->y > p1->y) theta = 360 - theta;
-            theta *= -1;
+            length = sqrt(pow(xDif, 2) + pow(yDif, 2));
+            theta = atan2(yDif, xDif) * 180 / PI;
 
             return this;
         }
@@ -108,27 +96,113 @@ class edge {
         }
 
         /*
-         * Returns if the given edge intersects with this one.
+         * Returns if the segment from a to b crosses this edge, 
+         * including touching it or overlapping it along the same 
+         * line.  Only the signs of orientations are compared, so 
+         * the answer is exact.
+         */
+        bool crosses(const ofPoint& a, const ofPoint& b) {
+            double d1 = orientation(*p1, *p2, a);
+            double d2 = orientation(*p1, *p2, b);
+            double d3 = orientation(a, b, *p1);
+            double d4 = orientation(a, b, *p2);
+            if (d1 * d2 > 0 || d3 * d4 > 0) return false;
+            //the segments straddle each other, or are on the same 
+            //line and only meet if their bounds overlap
+            return min(p1->x, p2->x) <= max(a.x, b.x) && min(a.x, b.x) <= max(p1->x, p2->x) &&
+                   min(p1->y, p2->y) <= max(a.y, b.y) && min(a.y, b.y) <= max(p1->y, p2->y);
+        }
+
+        /*
+         * Returns how far along the segment from a to b, from 0 to 1, 
+         * a point moving along it first comes within radius of this 
+         * edge, or -1 if it never does.  The edge is treated as a 
+         * capsule: a band along the edge with round ends.  Moves 
+         * that stay on one side of the edge's line, farther than 
+         * radius from it, are let through first.  Moves that cross 
+         * the edge always hit it, no later than where they cross.
          */
-        bool intersects(edge* e) {
-            int intersectX;
-            int intersectY;
-            if (yAxis && e->yAxis) return false;
-            else if (yAxis) {
-                intersectX = p1->x;
+        float sweep(const ofPoint& a, const ofPoint& b, float radius) {
+            double ex = (double)p2->x - p1->x, ey = (double)p2->y - p1->y;
+            double edgeSq = ex * ex + ey * ey;
+            double r2 = (double)radius * radius;
+            double da = orientation(*p1, *p2, a);
+            double db = orientation(*p1, *p2, b);
+            //orientations are the distance to the line times the length
+            if (da * db > 0 && da * da > r2 * edgeSq && db * db > r2 * edgeSq) return -1;
+            if (distanceSquared(a) <= r2) return 0;
+
+            double dx = (double)b.x - a.x, dy = (double)b.y - a.y;
+            double moveSq = dx * dx + dy * dy;
+            double first = 2;
+            if (moveSq == 0) return -1;
+            if (crosses(a, b) && da != db) first = da / (da - db);
+
+            //the round ends
+            ofPoint* ends[2] = {p1, p2};
+            for (int i = 0; i < 2; i++) {
+                double fx = (double)a.x - ends[i]->x, fy = (double)a.y - ends[i]->y;
+                double half = fx * dx + fy * dy;
+                double disc = half * half - moveSq * (fx * fx + fy * fy - r2);
+                if (disc >= 0) {
+                    double t = (-half - sqrt(disc)) / moveSq;
+                    if (t >= 0 && t <= 1 && t < first) first = t;
+                }
             }
-            else if (e->yAxis) {
-                intersectX = e->p1->x;
+            //the sides of the band
+            if (edgeSq > 0) {
+                double len = sqrt(edgeSq);
+                double nx = -ey / len, ny = ex / len;
+                double start = ((double)a.x - p1->x) * nx + ((double)a.y - p1->y) * ny;
+                double speed = dx * nx + dy * ny;
+                if (speed != 0) {
+                    for (int side = -1; side <= 1; side += 2) {
+                        double t = (side * radius - start) / speed;
+                        if (t < 0 || t > 1 || t >= first) continue;
+                        double along = ((a.x + dx * t - p1->x) * ex + (a.y + dy * t - p1->y) * ey) / edgeSq;
+                        if (along >= 0 && along <= 1) first = t;
+                    }
+                }
             }
-            else {intersectX = (e->yIntercept - yIntercept) / (slope - e->slope);}
-            intersectY = (slope * intersectX) + yIntercept;
-            return withinBounds(intersectX, intersectY, 0) && e->withinBounds(intersectX, intersectY, 0);
+            return first <= 1 ? first : -1;
+        }
+
+        /*
+         * Returns the point on the edge closest to the given point.
+         */
+        ofPoint closestPoint(const ofPoint& p) {
+            double ex = (double)p2->x - p1->x, ey = (double)p2->y - p1->y;
+            double edgeSq = ex * ex + ey * ey;
+            double t = 0;
+            if (edgeSq > 0) t = (((double)p.x - p1->x) * ex + ((double)p.y - p1->y) * ey) / edgeSq;
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+            return ofPoint(p1->x + ex * t, p1->y + ey * t);
+        }
+
+        /*
+         * Returns the squared distance from the given point to the 
+         * closest point on the edge.
+         */
+        double distanceSquared(const ofPoint& p) {
+            ofPoint closest = closestPoint(p);
+            double x = (double)closest.x - p.x, y = (double)closest.y - p.y;
+            return x * x + y * y;
+        }
+
+        /*
+         * Returns twice the signed area of the triangle a, b, c. 
+         * Positive if c is to the left of the line from a to b, 
+         * negative if to the right, and zero if on it.  Screen 
+         * coordinates are small enough for this to be exact in 
+         * doubles.
+         */
+        static double orientation(const ofPoint& a, const ofPoint& b, const ofPoint& c) {
+            return ((double)b.x - a.x) * ((double)c.y - a.y) - ((double)b.y - a.y) * ((double)c.x - a.x);
         }
 
         ofPoint* p1;
         ofPoint* p2;
-        double slope, yIntercept, length, theta;
-        bool xAxis, yAxis;
+        double length, theta;
 };
 
 #endif
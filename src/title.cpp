@@ -62,10 +62,16 @@ void title::draw() {
 
 /*
  * Updates the title screen.
- * TODO may not need a tracker at all.
  */
 void title::update() {
-    _tracker->update();
+}
+
+/*
+ * Returns how much tracking the title screen needs.  It is
+ * only driven by the mouse.
+ */
+int title::getTrackingDemand() {
+    return TRACK_NONE;
 }
 
 /*
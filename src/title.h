@@ -24,6 +24,7 @@ class title : public ofBaseApp {
         void setup(tracker* t, ofBaseApp* p);
         void update();
         void draw();
+        int getTrackingDemand();
 
         void mousePressed(int x, int y, int button);
 
@@ -0,0 +1,216 @@
+/*
+ * autoTuner.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Tunes the tracker offline.  Reads a recording 
+ * and the labelled target positions from settings/tuning.xml, 
+ * then scores every candidate setting on worker threads, one 
+ * per core.  The best setting is handed to the tracker and 
+ * saved as the configuration.
+ *
+ */
+
+#include "autoTuner.h"
+#include "XMLUtil.h"
+#include "Poco/Environment.h"
+
+/*
+ * Default constructor.
+ */
+autoTuner::autoTuner() {
+    _tracker = 0;
+    bestError = -1;
+    running = false;
+}
+
+/*
+ * Deleting the tuner.  Stops any workers still running.
+ */
+autoTuner::~autoTuner() {
+    stop();
+}
+
+/*
+ * Starts tuning the given tracker.  Decodes the labelled frames 
+ * of the recording on this thread, since the movie player is 
+ * not thread safe, then starts the workers.  Returns false if 
+ * there is nothing to tune on.
+ */
+bool autoTuner::start(tracker* t) {
+    if (running) return false;
+    _tracker = t;
+
+    XMLUtil xml;
+    string recording;
+    vector<tuningSample> samples;
+    if (!xml.loadTuning(recording, samples) || samples.empty()) return false;
+
+    //samples refer to frames of the movie, the tuner wants them to refer to the decoded frames
+    vector<int> frameNumbers;
+    for (int i = 0; i < samples.size(); i++) {
+        int index = find(frameNumbers.begin(), frameNumbers.end(), samples[i].frame) - frameNumbers.begin();
+        if (index == frameNumbers.size()) frameNumbers.push_back(samples[i].frame);
+        samples[i].frame = index;
+    }
+
+    vector<imageBuffer> frames;
+    if (!loadFrames(recording, frameNumbers, frames)) return false;
+    tuner.setup(frames, samples, _tracker->getSettings());
+    if (tuner.getNumCandidates() == 0) return false;
+
+    errors.assign(tuner.getNumCandidates(), -1);
+    bestError = -1;
+    int numWorkers = max(1, (int)Poco::Environment::processorCount());
+    for (int i = 0; i < numWorkers; i++) {
+        tuningWorker* worker = new tuningWorker();
+        worker->setup(this, i, numWorkers);
+        workers.push_back(worker);
+        worker->startThread(false, false);
+    }
+    running = true;
+    return true;
+}
+
+/*
+ * Stops and deletes the workers without using their results.
+ */
+void autoTuner::stop() {
+    for (int i = 0; i < workers.size(); i++) {
+        workers[i]->stopThread();
+        workers[i]->waitForThread(false);
+        delete workers[i];
+    }
+    workers.clear();
+    running = false;
+}
+
+/*
+ * Checks on the workers.  Once all of them are done, the best 
+ * candidate goes to the tracker and is saved.  Returns true 
+ * when that happens.
+ */
+bool autoTuner::update() {
+    if (!running) return false;
+    for (int i = 0; i < workers.size(); i++) {
+        if (!workers[i]->isFinished()) return false;
+    }
+    stop();
+
+    int best = 0;
+    for (int i = 1; i < errors.size(); i++) {
+        if (errors[i] >= 0 && (errors[best] < 0 || errors[i] < errors[best])) best = i;
+    }
+    if (errors[best] < 0) return false;
+    bestError = errors[best];
+
+    _tracker->setSettings(tuner.getCandidate(best));
+    XMLUtil xml;
+    xml.saveSettings(_tracker);
+    return true;
+}
+
+/*
+ * Returns if the workers are still going.
+ */
+bool autoTuner::isRunning() {
+    return running;
+}
+
+/*
+ * Returns the fraction of candidates scored so far.
+ */
+float autoTuner::getProgress() {
+    if (errors.empty()) return 0;
+    int done = 0;
+    for (int i = 0; i < workers.size(); i++) {
+        done += workers[i]->getDone();
+    }
+    return (float)done / errors.size();
+}
+
+/*
+ * Returns the average distance in pixels of the best candidate 
+ * from the labelled positions, or -1 if tuning has not finished.
+ */
+float autoTuner::getError() {
+    return bestError;
+}
+
+/*
+ * Decodes the given frames of the recording, mirrored and scaled 
+ * the way the tracker sees them.
+ */
+bool autoTuner::loadFrames(string path, vector<int>& frameNumbers, vector<imageBuffer>& frames) {
+    ofVideoPlayer player;
+    player.setUseTexture(false);
+    if (!player.loadMovie(path)) return false;
+    player.setPaused(true);
+
+    int width = _tracker->getCameraWidth();
+    int height = _tracker->getCameraHeight();
+    frames.resize(frameNumbers.size());
+    for (int i = 0; i < frameNumbers.size(); i++) {
+        player.setFrame(frameNumbers[i]);
+        player.update();
+        frames[i].allocate(width, height, 3);
+        frames[i].copyFrom(player.getPixels(), player.getWidth(), player.getHeight(), player.getWidth() * 3, true);
+    }
+    player.close();
+    return true;
+}
+
+/*
+ * Sets which candidates the worker scores.  Every worker gets 
+ * its own workspace so they never share buffers.
+ */
+void autoTuner::tuningWorker::setup(autoTuner* _owner, int _first, int _step) {
+    owner = _owner;
+    first = _first;
+    step = _step;
+    done = 0;
+    finished = false;
+    workspace.allocate(owner->tuner.width, owner->tuner.height);
+}
+
+/*
+ * Scores the worker's candidates.  Each writes to its own slot 
+ * of the error list; the score and the count of finished ones 
+ * are published under the lock, so the main thread sees them 
+ * together.
+ */
+void autoTuner::tuningWorker::threadedFunction() {
+    for (int i = first; i < owner->errors.size() && isThreadRunning(); i += step) {
+        float error = owner->tuner.evaluate(i, workspace);
+        lock();
+        owner->errors[i] = error;
+        done++;
+        unlock();
+    }
+    lock();
+    finished = true;
+    unlock();
+}
+
+/*
+ * Returns how many candidates the worker has scored.
+ */
+int autoTuner::tuningWorker::getDone() {
+    lock();
+    int _done = done;
+    unlock();
+    return _done;
+}
+
+/*
+ * Returns if the worker has scored all of its candidates, or 
+ * was stopped.
+ */
+bool autoTuner::tuningWorker::isFinished() {
+    lock();
+    bool _finished = finished;
+    unlock();
+    return _finished;
+}
@@ -0,0 +1,73 @@
+/*
+ * autoTuner.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Tunes the tracker offline.  Reads a recording 
+ * and the labelled target positions from settings/tuning.xml, 
+ * then scores every candidate setting on worker threads, one 
+ * per core.  The best setting is handed to the tracker and 
+ * saved as the configuration.
+ *
+ */
+
+#ifndef _AUTO_TUNER_H
+#define _AUTO_TUNER_H
+
+#include "ofMain.h"
+#include "tracker.h"
+#include "parameterTuner.h"
+
+class autoTuner {
+
+    public:
+
+        autoTuner();
+        virtual ~autoTuner();
+
+        bool start(tracker* t);
+        void stop();
+        bool update();
+
+        bool isRunning();
+        float getProgress();
+        float getError();
+
+    private:
+
+        /*
+         * Scores every n-th candidate, starting at the given one. 
+         * How far it got is only touched under the thread's lock.
+         */
+        class tuningWorker : public ofThread {
+
+            public:
+
+                void setup(autoTuner* _owner, int _first, int _step);
+                void threadedFunction();
+                int getDone();
+                bool isFinished();
+
+                autoTuner* owner;
+                int first, step;
+                tuningWorkspace workspace;
+
+            private:
+
+                int done;
+                bool finished;
+        };
+
+        bool loadFrames(string path, vector<int>& frameNumbers, vector<imageBuffer>& frames);
+
+        tracker* _tracker;
+        parameterTuner tuner;
+        vector<tuningWorker*> workers;
+        vector<float> errors;
+        float bestError;
+        bool running;
+};
+
+#endif
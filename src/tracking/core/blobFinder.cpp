@@ -0,0 +1,132 @@
+/*
+ * blobFinder.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Finds the connected blobs of set pixels in 
+ * a mask.  Each blob has its area, centroid and bounding box. 
+ * Blobs are sorted from largest to smallest.
+ *
+ */
+
+#include "blobFinder.h"
+#include <algorithm>
+
+/*
+ * Orders blobs from largest to smallest.
+ */
+static bool largerBlob(const blob& a, const blob& b) {
+    return a.area > b.area;
+}
+
+/*
+ * Default constructor.
+ */
+blobFinder::blobFinder() {
+}
+
+/*
+ * Allocates the label image for masks of the given size.
+ */
+void blobFinder::allocate(int _width, int _height) {
+    labels.assign(_width * _height, 0);
+}
+
+/*
+ * Finds the blobs in the mask.  Pixels touching in any of the 
+ * eight directions belong to the same blob.  The first pass 
+ * labels every set pixel from its already labelled neighbours 
+ * and records which labels meet.  The second pass adds every 
+ * pixel to the blob of its label's root.  Only blobs with an 
+ * area between minArea and maxArea are kept, at most maxBlobs 
+ * of them.  Returns the number of blobs.
+ */
+int blobFinder::find(const imageBuffer& mask, int minArea, int maxArea, int maxBlobs) {
+    int w = mask.width;
+    int h = mask.height;
+    parents.clear();
+    parents.push_back(0);
+
+    for (int y = 0; y < h; y++) {
+        const unsigned char* row = mask.getRow(y);
+        int* labelRow = &labels[y * w];
+        int* aboveRow = y > 0 ? &labels[(y - 1) * w] : 0;
+        for (int x = 0; x < w; x++) {
+            if (row[x] == 0) {
+                labelRow[x] = 0;
+                continue;
+            }
+            int label = 0;
+            if (x > 0 && labelRow[x-1]) label = labelRow[x-1];
+            if (aboveRow) {
+                if (x > 0 && aboveRow[x-1]) label = label ? join(label, aboveRow[x-1]) : aboveRow[x-1];
+                if (aboveRow[x]) label = label ? join(label, aboveRow[x]) : aboveRow[x];
+                if (x < w - 1 && aboveRow[x+1]) label = label ? join(label, aboveRow[x+1]) : aboveRow[x+1];
+            }
+            if (label == 0) {
+                label = parents.size();
+                parents.push_back(label);
+            }
+            labelRow[x] = label;
+        }
+    }
+
+    blob empty = {0, 0, 0, w, h, -1, -1};
+    found.assign(parents.size(), empty);
+    for (int y = 0; y < h; y++) {
+        const int* labelRow = &labels[y * w];
+        for (int x = 0; x < w; x++) {
+            if (labelRow[x] == 0) continue;
+            blob& b = found[root(labelRow[x])];
+            b.area++;
+            b.x += x;
+            b.y += y;
+            if (x < b.left) b.left = x;
+            if (x > b.right) b.right = x;
+            if (y < b.top) b.top = y;
+            if (y > b.bottom) b.bottom = y;
+        }
+    }
+
+    blobs.clear();
+    for (int i = 1; i < found.size(); i++) {
+        blob& b = found[i];
+        if (b.area >= minArea && b.area <= maxArea) {
+            b.x /= b.area;
+            b.y /= b.area;
+            blobs.push_back(b);
+        }
+    }
+    std::sort(blobs.begin(), blobs.end(), largerBlob);
+    if (blobs.size() > maxBlobs) blobs.resize(maxBlobs);
+    return blobs.size();
+}
+
+/*
+ * Returns the root of the given label, shortening the path to 
+ * it on the way.
+ */
+int blobFinder::root(int label) {
+    while (parents[label] != label) {
+        parents[label] = parents[parents[label]];
+        label = parents[label];
+    }
+    return label;
+}
+
+/*
+ * Joins the two labels into one blob.  Returns the root of the 
+ * joined blob.
+ */
+int blobFinder::join(int a, int b) {
+    a = root(a);
+    b = root(b);
+    if (a < b) {
+        parents[b] = a;
+        return a;
+    }
+    parents[a] = b;
+    return b;
+}
@@ -0,0 +1,46 @@
+/*
+ * blobFinder.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Finds the connected blobs of set pixels in 
+ * a mask.  Each blob has its area, centroid and bounding box. 
+ * Blobs are sorted from largest to smallest.
+ *
+ */
+
+#ifndef _BLOB_FINDER_H
+#define _BLOB_FINDER_H
+
+#include "imageBuffer.h"
+
+struct blob {
+    float area;
+    float x, y;
+    int left, top, right, bottom;
+};
+
+class blobFinder {
+
+    public:
+
+        blobFinder();
+
+        void allocate(int _width, int _height);
+        int find(const imageBuffer& mask, int minArea, int maxArea, int maxBlobs);
+
+        std::vector<blob> blobs;
+
+    private:
+
+        int root(int label);
+        int join(int a, int b);
+
+        std::vector<int> labels;
+        std::vector<int> parents;
+        std::vector<blob> found;
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * camShift.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Follows a target described by a hue-saturation 
+ * histogram.  Only the search window around the target and a 
+ * margin around it are looked at, so the cost depends on the 
+ * size of the target rather than that of the frame.
+ *
+ */
+
+#include "camShift.h"
+#include "colorConversion.h"
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+/*
+ * Default constructor.  Fills the tables that map hue and 
+ * saturation to histogram bins.
+ */
+camShift::camShift() {
+    width = height = 0;
+    winX = winY = winW = winH = 0;
+    targetX = targetY = targetArea = 0;
+    for (int i = 0; i < 256; i++) {
+        hueBin[i] = min(i * HIST_HUE_BINS / 180, HIST_HUE_BINS - 1);
+        satBin[i] = i * HIST_SAT_BINS / 256;
+    }
+}
+
+/*
+ * Sets the size of the frames that will be tracked.
+ */
+void camShift::setup(int _width, int _height) {
+    width = _width;
+    height = _height;
+    resetWindow();
+}
+
+/*
+ * Follows the target.  Only the search window and a margin of its 
+ * own size around it are converted to HSV and back-projected through 
+ * the histogram.  The window is moved to the centroid of the 
+ * back-projection until it settles, then resized to fit the mass it 
+ * found.  If the target is lost, the next frame searches the whole 
+ * image again.  Returns if the target was found.
+ */
+bool camShift::track(const imageBuffer& rgb, imageBuffer& hsv, const unsigned char* histogram) {
+    //convert the search window and a margin of its own size around it
+    int rx = max(winX - winW / 2, 0);
+    int ry = max(winY - winH / 2, 0);
+    int rw = min(winX + winW + winW / 2, width) - rx;
+    int rh = min(winY + winH + winH / 2, height) - ry;
+    colorConversion::toHsv(rgb, hsv, rx, ry, rw, rh);
+
+    double m00 = 0;
+    for (int i = 0; i < MEANSHIFT_ITERATIONS; i++) {
+        //keep the window inside the converted region
+        winX = min(max(winX, rx), rx + rw - winW);
+        winY = min(max(winY, ry), ry + rh - winH);
+
+        double m10 = 0, m01 = 0;
+        m00 = 0;
+        for (int py = winY; py < winY + winH; py++) {
+            const unsigned char* row = hsv.getRow(py);
+            for (int px = winX; px < winX + winW; px++) {
+                int weight = histogram[hueBin[row[px*3]] * HIST_SAT_BINS + satBin[row[px*3+1]]];
+                m00 += weight;
+                m10 += weight * px;
+                m01 += weight * py;
+            }
+        }
+        if (m00 < CAMSHIFT_MIN_MASS) break;
+
+        double dx = m10 / m00 - (winX + winW / 2.0);
+        double dy = m01 / m00 - (winY + winH / 2.0);
+        winX += (int)floor(dx + 0.5);
+        winY += (int)floor(dy + 0.5);
+        if (fabs(dx) < 1 && fabs(dy) < 1) break;
+    }
+
+    if (m00 < CAMSHIFT_MIN_MASS) {
+        resetWindow();
+        return false;
+    }
+
+    //adapt the window to the size of the target
+    targetX = winX + winW / 2.0f;
+    targetY = winY + winH / 2.0f;
+    targetArea = m00 / 255;
+    int size = max((int)(2 * sqrt(targetArea)), CAMSHIFT_MIN_SIZE);
+    winW = min(size, width);
+    winH = min((int)(size * 1.2f), height);
+    winX = min(max((int)(targetX - winW / 2), 0), width - winW);
+    winY = min(max((int)(targetY - winH / 2), 0), height - winH);
+    return true;
+}
+
+/*
+ * Builds the target histogram from a patch of pixels around the 
+ * given position.  Hue and saturation are binned together and the 
+ * result is scaled so the largest bin is 255.  Pixels with too 
+ * little saturation are left out since their hue is meaningless. 
+ * The search window is set to the patch.  Returns false if there 
+ * was nothing to build a histogram from.
+ */
+bool camShift::buildHistogram(const imageBuffer& rgb, imageBuffer& hsv, int x, int y, unsigned char* histogram) {
+    int left = max(x - HIST_PATCH_SIZE / 2, 0);
+    int top = max(y - HIST_PATCH_SIZE / 2, 0);
+    int right = min(left + HIST_PATCH_SIZE, width);
+    int bottom = min(top + HIST_PATCH_SIZE, height);
+    colorConversion::toHsv(rgb, hsv, left, top, right - left, bottom - top);
+
+    int counts[HIST_BINS];
+    for (int i = 0; i < HIST_BINS; i++) {
+        counts[i] = 0;
+    }
+    int maxCount = 0;
+    for (int py = top; py < bottom; py++) {
+        const unsigned char* row = hsv.getRow(py);
+        for (int px = left; px < right; px++) {
+            if (row[px*3+1] < CAMSHIFT_MIN_SAT) continue;
+            int bin = hueBin[row[px*3]] * HIST_SAT_BINS + satBin[row[px*3+1]];
+            counts[bin]++;
+            maxCount = max(maxCount, counts[bin]);
+        }
+    }
+    if (maxCount == 0) return false;
+
+    for (int i = 0; i < HIST_BINS; i++) {
+        histogram[i] = counts[i] * 255 / maxCount;
+    }
+    setWindow(left, top, right - left, bottom - top);
+    return true;
+}
+
+/*
+ * Sets the search window.
+ */
+void camShift::setWindow(int x, int y, int w, int h) {
+    winX = x;
+    winY = y;
+    winW = w;
+    winH = h;
+}
+
+/*
+ * Makes the search window cover the whole image.
+ */
+void camShift::resetWindow() {
+    setWindow(0, 0, width, height);
+}
@@ -0,0 +1,49 @@
+/*
+ * camShift.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Follows a target described by a hue-saturation 
+ * histogram.  Only the search window around the target and a 
+ * margin around it are looked at, so the cost depends on the 
+ * size of the target rather than that of the frame.
+ *
+ */
+
+#ifndef _CAM_SHIFT_H
+#define _CAM_SHIFT_H
+
+#include "imageBuffer.h"
+#include "trackerSettings.h"
+
+#define HIST_PATCH_SIZE 16
+#define CAMSHIFT_MIN_SAT 30
+#define CAMSHIFT_MIN_MASS (255 * 8)
+#define CAMSHIFT_MIN_SIZE 8
+#define MEANSHIFT_ITERATIONS 10
+
+class camShift {
+
+    public:
+
+        camShift();
+
+        void setup(int _width, int _height);
+        bool track(const imageBuffer& rgb, imageBuffer& hsv, const unsigned char* histogram);
+        bool buildHistogram(const imageBuffer& rgb, imageBuffer& hsv, int x, int y, unsigned char* histogram);
+
+        void setWindow(int x, int y, int w, int h);
+        void resetWindow();
+
+        int winX, winY, winW, winH;
+        float targetX, targetY, targetArea;
+
+    private:
+
+        int width, height;
+        unsigned char hueBin[256], satBin[256];
+};
+
+#endif
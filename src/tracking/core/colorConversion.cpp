@@ -0,0 +1,60 @@
+/*
+ * colorConversion.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Converts RGB pixels to grayscale and HSV.  
+ * Gives the same 8 bit results as OpenCV, i.e. hue is 
+ * 0-179 and saturation and value are 0-255.
+ *
+ */
+
+#include "colorConversion.h"
+
+int colorConversion::hueDivision[256];
+int colorConversion::saturationDivision[256];
+
+/*
+ * Fills the division tables before anything is converted.  
+ * Dividing by 0 gives 0, which is what a gray pixel needs.
+ */
+struct divisionTables {
+    divisionTables() {
+        colorConversion::hueDivision[0] = colorConversion::saturationDivision[0] = 0;
+        for (int i = 1; i < 256; i++) {
+            colorConversion::hueDivision[i] = (int)(180.0 * (1 << HSV_SHIFT) / (6.0 * i) + 0.5);
+            colorConversion::saturationDivision[i] = (int)(255.0 * (1 << HSV_SHIFT) / i + 0.5);
+        }
+    }
+};
+
+static divisionTables tables;
+
+/*
+ * Converts a whole RGB image to grayscale.
+ */
+void colorConversion::toGray(const imageBuffer& rgb, imageBuffer& gray) {
+    for (int y = 0; y < rgb.height; y++) {
+        const unsigned char* src = rgb.getRow(y);
+        unsigned char* dst = gray.getRow(y);
+        for (int x = 0; x < rgb.width; x++) {
+            dst[x] = grayPixel(src + x * 3);
+        }
+    }
+}
+
+/*
+ * Converts the given region of an RGB image to HSV.  The rest 
+ * of the HSV image is left as it was.
+ */
+void colorConversion::toHsv(const imageBuffer& rgb, imageBuffer& hsv, int x, int y, int w, int h) {
+    for (int py = y; py < y + h; py++) {
+        const unsigned char* src = rgb.getRow(py) + x * 3;
+        unsigned char* dst = hsv.getRow(py) + x * 3;
+        for (int px = 0; px < w; px++) {
+            hsvPixel(src + px * 3, dst + px * 3);
+        }
+    }
+}
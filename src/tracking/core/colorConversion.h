@@ -0,0 +1,62 @@
+/*
+ * colorConversion.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Converts RGB pixels to grayscale and HSV.  
+ * Gives the same 8 bit results as OpenCV, i.e. hue is 
+ * 0-179 and saturation and value are 0-255.
+ *
+ */
+
+#ifndef _COLOR_CONVERSION_H
+#define _COLOR_CONVERSION_H
+
+#include "imageBuffer.h"
+
+#define HSV_SHIFT 12
+
+class colorConversion {
+
+    public:
+
+        static void toGray(const imageBuffer& rgb, imageBuffer& gray);
+        static void toHsv(const imageBuffer& rgb, imageBuffer& hsv, int x, int y, int w, int h);
+
+        /*
+         * Converts a single RGB pixel to grayscale.
+         */
+        static inline unsigned char grayPixel(const unsigned char* rgb) {
+            return (rgb[0] * 4899 + rgb[1] * 9617 + rgb[2] * 1868 + (1 << 13)) >> 14;
+        }
+
+        /*
+         * Converts a single RGB pixel to HSV.
+         */
+        static inline void hsvPixel(const unsigned char* rgb, unsigned char* hsv) {
+            int r = rgb[0], g = rgb[1], b = rgb[2];
+            int v = r > g ? (r > b ? r : b) : (g > b ? g : b);
+            int vmin = r < g ? (r < b ? r : b) : (g < b ? g : b);
+            int diff = v - vmin;
+            int h;
+            if (v == r) h = g - b;
+            else if (v == g) h = b - r + 2 * diff;
+            else {h = r - g + 4 * diff;}
+            h = (h * hueDivision[diff] + (1 << (HSV_SHIFT - 1))) >> HSV_SHIFT;
+            if (h < 0) h += 180;
+            hsv[0] = h;
+            hsv[1] = (diff * saturationDivision[v] + (1 << (HSV_SHIFT - 1))) >> HSV_SHIFT;
+            hsv[2] = v;
+        }
+
+    private:
+
+        friend struct divisionTables;
+
+        static int hueDivision[256];
+        static int saturationDivision[256];
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * flightRecorder.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Keeps the last few seconds of what the tracker 
+ * saw in memory, so a problem can be looked at after it happened. 
+ * Every frame is kept as a downsampled grayscale image and a run 
+ * length encoded mask, along with what was found in it.  Frames 
+ * older than the time limit, or over the memory budget, are 
+ * dropped and their memory reused for new ones.
+ *
+ */
+
+#include "flightRecorder.h"
+#include <stdio.h>
+
+/*
+ * Default constructor.
+ */
+flightRecorder::flightRecorder() {
+    seconds = RECORDER_SECONDS;
+    budget = RECORDER_BUDGET;
+    bytes = 0;
+}
+
+/*
+ * Deleting the recorder.
+ */
+flightRecorder::~flightRecorder() {
+    for (int i = 0; i < frames.size(); i++) {
+        delete frames[i];
+    }
+    for (int i = 0; i < spare.size(); i++) {
+        delete spare[i];
+    }
+}
+
+/*
+ * Sets how many seconds to keep, and how many bytes they may 
+ * take up at most.
+ */
+void flightRecorder::setup(double _seconds, int _budget) {
+    seconds = _seconds;
+    budget = _budget;
+}
+
+/*
+ * Records a frame given as RGB pixels, its size and its stride, 
+ * along with the mask and what was found in it.  The frame is 
+ * mirrored if asked, like the tracker core does.  The mask may be 
+ * null, if there isn't one.  Old frames are dropped first, so the 
+ * memory they used can be reused.
+ */
+void flightRecorder::record(double time, const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror,
+                            const imageBuffer* mask, bool found, float x, float y, float area) {
+    while (!frames.empty() && frames.front()->time < time - seconds) {
+        drop();
+    }
+
+    recordedFrame* frame;
+    if (spare.empty()) frame = new recordedFrame();
+    else {
+        frame = spare.back();
+        spare.pop_back();
+    }
+
+    frame->time = time;
+    frame->found = found;
+    frame->x = x;
+    frame->y = y;
+    frame->area = area;
+
+    frame->lumaWidth = srcWidth / RECORDER_SCALE;
+    frame->lumaHeight = srcHeight / RECORDER_SCALE;
+    frame->luma.resize(frame->lumaWidth * frame->lumaHeight);
+    for (int j = 0; j < frame->lumaHeight; j++) {
+        const unsigned char* row = pixels + j * RECORDER_SCALE * srcStride;
+        unsigned char* out = &frame->luma[j * frame->lumaWidth];
+        for (int i = 0; i < frame->lumaWidth; i++) {
+            int srcX = mirror ? srcWidth - 1 - i * RECORDER_SCALE : i * RECORDER_SCALE;
+            const unsigned char* p = row + srcX * 3;
+            out[i] = (p[0] * 77 + p[1] * 150 + p[2] * 29) >> 8;
+        }
+    }
+
+    frame->mask.clear();
+    frame->maskWidth = frame->maskHeight = 0;
+    if (mask != 0 && mask->isAllocated()) {
+        frame->maskWidth = mask->width;
+        frame->maskHeight = mask->height;
+        encodeMask(*mask, frame->mask);
+    }
+
+    frames.push_back(frame);
+    bytes += size(frame);
+    while (bytes > budget && frames.size() > 1) {
+        drop();
+    }
+}
+
+/*
+ * Sets what was found in the frame recorded at the given time, for 
+ * results that arrive after their frame.  Returns false if that 
+ * frame isn't kept anymore.
+ */
+bool flightRecorder::setResult(double time, bool found, float x, float y, float area) {
+    for (int i = (int)frames.size() - 1; i >= 0; i--) {
+        if (frames[i]->time != time) continue;
+        frames[i]->found = found;
+        frames[i]->x = x;
+        frames[i]->y = y;
+        frames[i]->area = area;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Writes every frame to the given directory, which must exist. 
+ * Images go to numbered PGM files and what was found to 
+ * samples.csv.  Returns false if something couldn't be written.
+ */
+bool flightRecorder::dump(std::string directory) {
+    FILE* samples = fopen((directory + "/samples.csv").c_str(), "w");
+    if (samples == 0) return false;
+    fprintf(samples, "frame,time,found,x,y,area\n");
+
+    std::vector<unsigned char> decoded;
+    char name[32];
+    for (int i = 0; i < frames.size(); i++) {
+        const recordedFrame* frame = frames[i];
+        fprintf(samples, "%d,%.3f,%d,%.1f,%.1f,%.0f\n", i, frame->time, frame->found ? 1 : 0, frame->x, frame->y, frame->area);
+
+        sprintf(name, "/luma%05d.pgm", i);
+        FILE* image = fopen((directory + name).c_str(), "wb");
+        if (image == 0) {
+            fclose(samples);
+            return false;
+        }
+        fprintf(image, "P5\n%d %d\n255\n", frame->lumaWidth, frame->lumaHeight);
+        fwrite(&frame->luma[0], 1, frame->luma.size(), image);
+        fclose(image);
+
+        if (frame->mask.empty()) continue;
+        decodeMask(frame->mask, decoded);
+        sprintf(name, "/mask%05d.pgm", i);
+        image = fopen((directory + name).c_str(), "wb");
+        if (image == 0) {
+            fclose(samples);
+            return false;
+        }
+        fprintf(image, "P5\n%d %d\n255\n", frame->maskWidth, frame->maskHeight);
+        fwrite(&decoded[0], 1, decoded.size(), image);
+        fclose(image);
+    }
+    fclose(samples);
+    return true;
+}
+
+/*
+ * Returns the number of frames kept.
+ */
+int flightRecorder::getNumFrames() {
+    return frames.size();
+}
+
+/*
+ * Returns the number of bytes the frames kept take up.
+ */
+int flightRecorder::getBytes() {
+    return bytes;
+}
+
+/*
+ * Drops the oldest frame, keeping it for reuse.
+ */
+void flightRecorder::drop() {
+    bytes -= size(frames.front());
+    spare.push_back(frames.front());
+    frames.pop_front();
+}
+
+/*
+ * Returns about how many bytes a frame takes up.
+ */
+int flightRecorder::size(const recordedFrame* frame) {
+    return sizeof(recordedFrame) + frame->luma.capacity() + frame->mask.capacity();
+}
+
+/*
+ * Run length encodes a mask.  Runs alternate between empty and 
+ * set pixels, starting with empty ones.
+ */
+void flightRecorder::encodeMask(const imageBuffer& mask, std::vector<unsigned char>& runs) {
+    bool set = false;
+    int run = 0;
+    for (int y = 0; y < mask.height; y++) {
+        const unsigned char* row = mask.getRow(y);
+        for (int x = 0; x < mask.width; x++) {
+            if ((row[x] != 0) != set) {
+                runs.push_back(run);
+                set = !set;
+                run = 0;
+            }
+            if (run == 255) {
+                runs.push_back(255);
+                runs.push_back(0);
+                run = 0;
+            }
+            run++;
+        }
+    }
+    runs.push_back(run);
+}
+
+/*
+ * Decodes a run length encoded mask.
+ */
+void flightRecorder::decodeMask(const std::vector<unsigned char>& runs, std::vector<unsigned char>& mask) {
+    mask.clear();
+    unsigned char value = 0;
+    for (int i = 0; i < runs.size(); i++) {
+        mask.insert(mask.end(), runs[i], value);
+        value = 255 - value;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * flightRecorder.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Keeps the last few seconds of what the tracker 
+ * saw in memory, so a problem can be looked at after it happened. 
+ * Every frame is kept as a downsampled grayscale image and a run 
+ * length encoded mask, along with what was found in it.  Frames 
+ * older than the time limit, or over the memory budget, are 
+ * dropped and their memory reused for new ones.
+ *
+ */
+
+#ifndef _FLIGHT_RECORDER_H
+#define _FLIGHT_RECORDER_H
+
+#include "imageBuffer.h"
+#include <deque>
+#include <string>
+
+#define RECORDER_SCALE 2
+#define RECORDER_SECONDS 10
+#define RECORDER_BUDGET (8 * 1024 * 1024)
+
+/*
+ * A recorded frame.  The mask is a list of run lengths, starting 
+ * with a run of empty pixels.  Runs longer than 255 are split 
+ * with runs of length 0.
+ */
+struct recordedFrame {
+    double time;
+    bool found;
+    float x, y, area;
+    int lumaWidth, lumaHeight;
+    int maskWidth, maskHeight;
+    std::vector<unsigned char> luma, mask;
+};
+
+class flightRecorder {
+
+    public:
+
+        flightRecorder();
+        virtual ~flightRecorder();
+
+        void setup(double _seconds, int _budget);
+        void record(double time, const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror,
+                    const imageBuffer* mask, bool found, float x, float y, float area);
+        bool setResult(double time, bool found, float x, float y, float area);
+        bool dump(std::string directory);
+
+        int getNumFrames();
+        int getBytes();
+
+    private:
+
+        void drop();
+        static int size(const recordedFrame* frame);
+        static void encodeMask(const imageBuffer& mask, std::vector<unsigned char>& runs);
+        static void decodeMask(const std::vector<unsigned char>& runs, std::vector<unsigned char>& mask);
+
+        std::deque<recordedFrame*> frames;
+        std::vector<recordedFrame*> spare;
+        double seconds;
+        int budget, bytes;
+};
+
+#endif
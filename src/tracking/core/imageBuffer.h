@@ -0,0 +1,125 @@
+/*
+ * imageBuffer.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A plain image in memory.  Rows of 8 bit 
+ * pixels with any number of interleaved channels, each row 
+ * starting stride bytes after the previous one.  Doesn't 
+ * depend on openFrameworks so the tracker core can run 
+ * without a window.
+ *
+ */
+
+#ifndef _IMAGE_BUFFER_H
+#define _IMAGE_BUFFER_H
+
+#include <vector>
+#include <string.h>
+
+class imageBuffer {
+
+    public:
+
+        /*
+         * Default constructor.  An empty image.
+         */
+        imageBuffer() {
+            width = 0;
+            height = 0;
+            channels = 0;
+            stride = 0;
+        }
+
+        /*
+         * Allocates the image.  Rows are packed, i.e. the stride 
+         * is the width times the number of channels.  Pixels are 
+         * set to 0.
+         */
+        void allocate(int _width, int _height, int _channels) {
+            width = _width;
+            height = _height;
+            channels = _channels;
+            stride = width * channels;
+            data.assign(stride * height, 0);
+        }
+
+        /*
+         * Frees the image's memory.
+         */
+        void release() {
+            std::vector<unsigned char>().swap(data);
+            width = height = channels = stride = 0;
+        }
+
+        /*
+         * Returns if the image has been allocated.
+         */
+        bool isAllocated() const {
+            return !data.empty();
+        }
+
+        /*
+         * Returns a pointer to the first pixel.
+         */
+        unsigned char* getPixels() {
+            return &data[0];
+        }
+
+        const unsigned char* getPixels() const {
+            return &data[0];
+        }
+
+        /*
+         * Returns a pointer to the first pixel of the given row.
+         */
+        unsigned char* getRow(int y) {
+            return &data[y * stride];
+        }
+
+        const unsigned char* getRow(int y) const {
+            return &data[y * stride];
+        }
+
+        /*
+         * Sets every pixel to the given value.
+         */
+        void set(unsigned char value) {
+            data.assign(data.size(), value);
+        }
+
+        /*
+         * Copies an image given as a pointer, size and stride into 
+         * this one.  The source has the same number of channels.  If 
+         * its size is different it is scaled to fit, and if mirror 
+         * is set it is flipped horizontally on the way.
+         */
+        void copyFrom(const unsigned char* src, int srcWidth, int srcHeight, int srcStride, bool mirror) {
+            if (!mirror && srcWidth == width && srcHeight == height) {
+                for (int y = 0; y < height; y++) {
+                    memcpy(getRow(y), src + y * srcStride, width * channels);
+                }
+                return;
+            }
+            for (int y = 0; y < height; y++) {
+                const unsigned char* srcRow = src + (y * srcHeight / height) * srcStride;
+                unsigned char* row = getRow(y);
+                for (int x = 0; x < width; x++) {
+                    int srcX = (mirror ? width - 1 - x : x) * srcWidth / width;
+                    for (int c = 0; c < channels; c++) {
+                        row[x * channels + c] = srcRow[srcX * channels + c];
+                    }
+                }
+            }
+        }
+
+        int width, height, channels, stride;
+
+    private:
+
+        std::vector<unsigned char> data;
+};
+
+#endif
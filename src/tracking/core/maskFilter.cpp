@@ -0,0 +1,158 @@
+/*
+ * maskFilter.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Cleans up a mask before its blobs are found.  
+ * Dilating joins pixels that belong together, blurring and 
+ * thresholding again grows the blobs a little further and 
+ * drops single stray pixels.
+ *
+ */
+
+#include "maskFilter.h"
+
+/*
+ * Default constructor.
+ */
+maskFilter::maskFilter() {
+}
+
+/*
+ * Allocates the working buffer for masks of the given size.
+ */
+void maskFilter::allocate(int _width, int _height) {
+    temp.allocate(_width, _height, 1);
+    sums.assign(_width, 0);
+}
+
+/*
+ * Dilates, blurs and thresholds the mask.
+ */
+void maskFilter::clean(imageBuffer& mask) {
+    dilate(mask);
+    blur(mask, MASK_BLUR_RADIUS);
+    threshold(mask, MASK_THRESHOLD);
+}
+
+/*
+ * Dilates the mask with a 3x3 square.  Done as a horizontal 
+ * and a vertical pass, each taking the max of three pixels.
+ */
+void maskFilter::dilate(imageBuffer& mask) {
+    int w = mask.width;
+    int h = mask.height;
+    for (int y = 0; y < h; y++) {
+        const unsigned char* src = mask.getRow(y);
+        unsigned char* dst = temp.getRow(y);
+        for (int x = 0; x < w; x++) {
+            unsigned char m = src[x];
+            if (x > 0 && src[x-1] > m) m = src[x-1];
+            if (x < w - 1 && src[x+1] > m) m = src[x+1];
+            dst[x] = m;
+        }
+    }
+    for (int y = 0; y < h; y++) {
+        const unsigned char* above = temp.getRow(y > 0 ? y - 1 : y);
+        const unsigned char* row = temp.getRow(y);
+        const unsigned char* below = temp.getRow(y < h - 1 ? y + 1 : y);
+        unsigned char* dst = mask.getRow(y);
+        for (int x = 0; x < w; x++) {
+            unsigned char m = row[x];
+            if (above[x] > m) m = above[x];
+            if (below[x] > m) m = below[x];
+            dst[x] = m;
+        }
+    }
+}
+
+/*
+ * Blurs the mask with a (2 * radius + 1) square box.  Done as a 
+ * horizontal and a vertical pass with running sums, so the cost 
+ * doesn't depend on the radius.  Pixels past the border repeat 
+ * the border pixel.
+ */
+void maskFilter::blur(imageBuffer& mask, int radius) {
+    blurThreshold(mask, radius, -1);
+}
+
+/*
+ * Blurs the mask like blur() and thresholds it like threshold() 
+ * while writing the result of the vertical pass, which saves a 
+ * pass over the mask.  A negative value leaves the blurred mask 
+ * as it is.
+ */
+void maskFilter::blurThreshold(imageBuffer& mask, int radius, int value) {
+    int w = mask.width;
+    int h = mask.height;
+    int size = 2 * radius + 1;
+    blurRows(mask, radius);
+
+    //the vertical pass keeps a running sum per column so rows are read in order
+    for (int x = 0; x < w; x++) {
+        sums[x] = temp.getRow(0)[x] * (radius + 1);
+    }
+    for (int y = 1; y <= radius; y++) {
+        const unsigned char* row = temp.getRow(y < h ? y : h - 1);
+        for (int x = 0; x < w; x++) {
+            sums[x] += row[x];
+        }
+    }
+    for (int y = 0; y < h; y++) {
+        unsigned char* dst = mask.getRow(y);
+        int add = y + radius + 1;
+        int sub = y - radius;
+        const unsigned char* addRow = temp.getRow(add < h ? add : h - 1);
+        const unsigned char* subRow = temp.getRow(sub > 0 ? sub : 0);
+        if (value < 0) {
+            for (int x = 0; x < w; x++) {
+                dst[x] = (sums[x] + size / 2) / size;
+                sums[x] += addRow[x] - subRow[x];
+            }
+        }
+        else {
+            for (int x = 0; x < w; x++) {
+                dst[x] = (sums[x] + size / 2) / size > value ? 255 : 0;
+                sums[x] += addRow[x] - subRow[x];
+            }
+        }
+    }
+}
+
+/*
+ * The horizontal pass of the box blur.  Writes the blurred rows 
+ * into the working buffer.
+ */
+void maskFilter::blurRows(const imageBuffer& mask, int radius) {
+    int w = mask.width;
+    int size = 2 * radius + 1;
+    for (int y = 0; y < mask.height; y++) {
+        const unsigned char* src = mask.getRow(y);
+        unsigned char* dst = temp.getRow(y);
+        int sum = src[0] * (radius + 1);
+        for (int x = 1; x <= radius; x++) {
+            sum += src[x < w ? x : w - 1];
+        }
+        for (int x = 0; x < w; x++) {
+            dst[x] = (sum + size / 2) / size;
+            int add = x + radius + 1;
+            int sub = x - radius;
+            sum += src[add < w ? add : w - 1] - src[sub > 0 ? sub : 0];
+        }
+    }
+}
+
+/*
+ * Sets every pixel brighter than the given value to 255, all 
+ * others to 0.
+ */
+void maskFilter::threshold(imageBuffer& mask, int value) {
+    for (int y = 0; y < mask.height; y++) {
+        unsigned char* row = mask.getRow(y);
+        for (int x = 0; x < mask.width; x++) {
+            row[x] = row[x] > value ? 255 : 0;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * maskFilter.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Cleans up a mask before its blobs are found.  
+ * Dilating joins pixels that belong together, blurring and 
+ * thresholding again grows the blobs a little further and 
+ * drops single stray pixels.
+ *
+ */
+
+#ifndef _MASK_FILTER_H
+#define _MASK_FILTER_H
+
+#include "imageBuffer.h"
+
+#define MASK_BLUR_RADIUS 5
+#define MASK_THRESHOLD 10
+
+class maskFilter {
+
+    public:
+
+        maskFilter();
+
+        void allocate(int _width, int _height);
+        void clean(imageBuffer& mask);
+
+        void dilate(imageBuffer& mask);
+        void blur(imageBuffer& mask, int radius);
+        void threshold(imageBuffer& mask, int value);
+        void blurThreshold(imageBuffer& mask, int radius, int value);
+
+    private:
+
+        void blurRows(const imageBuffer& mask, int radius);
+
+        imageBuffer temp;
+        std::vector<int> sums;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * parameterTuner.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Finds the tracker settings that work best on 
+ * recorded frames with known target positions.  Candidate 
+ * settings are scored by how far the target they find is from 
+ * where it really is.  The grayscale and HSV versions of every 
+ * frame are made once and shared by all candidates, and 
+ * candidates can be evaluated from several threads at once, 
+ * each with its own workspace.
+ *
+ */
+
+#include "parameterTuner.h"
+#include <math.h>
+#include <algorithm>
+
+/*
+ * Default constructor.
+ */
+parameterTuner::parameterTuner() {
+    width = height = 0;
+    minArea = maxArea = 0;
+    missPenalty = 0;
+}
+
+/*
+ * Sets up the tuner.  The frames are already mirrored the way 
+ * the tracker sees them and the samples are in their coordinates. 
+ * Converts every frame to grayscale and HSV, and builds the grid 
+ * of candidates: every threshold in LIGHT mode, and in MANUAL mode 
+ * every combination of ranges around the median color found at 
+ * the samples.
+ */
+void parameterTuner::setup(const std::vector<imageBuffer>& frames, const std::vector<tuningSample>& _samples, const trackerSettings& base) {
+    samples = _samples;
+    candidates.clear();
+    if (frames.empty() || samples.empty()) return;
+
+    width = frames[0].width;
+    height = frames[0].height;
+    minArea = 2;
+    maxArea = (int)(width * height * .33);
+    missPenalty = sqrt((float)(width * width + height * height));
+
+    grays.resize(frames.size());
+    hsvs.resize(frames.size());
+    for (int i = 0; i < frames.size(); i++) {
+        grays[i].allocate(width, height, 1);
+        hsvs[i].allocate(width, height, 3);
+        colorConversion::toGray(frames[i], grays[i]);
+        colorConversion::toHsv(frames[i], hsvs[i], 0, 0, width, height);
+    }
+
+    std::vector<int> hues, saturations, values;
+    for (int i = 0; i < samples.size(); i++) {
+        int x = std::max(0, std::min((int)samples[i].x, width - 1));
+        int y = std::max(0, std::min((int)samples[i].y, height - 1));
+        const unsigned char* p = hsvs[samples[i].frame].getRow(y) + x * 3;
+        hues.push_back(p[0]);
+        saturations.push_back(p[1]);
+        values.push_back(p[2]);
+    }
+    std::sort(hues.begin(), hues.end());
+    std::sort(saturations.begin(), saturations.end());
+    std::sort(values.begin(), values.end());
+
+    trackerSettings candidate = base;
+    candidate.mode = LIGHT;
+    for (int t = 0; t < 256; t += TUNE_THRESHOLD_STEP) {
+        candidate.threshold = t;
+        candidates.push_back(candidate);
+    }
+
+    candidate = base;
+    candidate.mode = MANUAL;
+    candidate.hue = hues[hues.size() / 2];
+    candidate.saturation = saturations[saturations.size() / 2];
+    candidate.value = values[values.size() / 2];
+    for (int h = TUNE_HUE_RANGE_STEP; h <= TUNE_HUE_RANGE_MAX; h += TUNE_HUE_RANGE_STEP) {
+        for (int s = TUNE_SV_RANGE_STEP; s <= TUNE_SV_RANGE_MAX; s += TUNE_SV_RANGE_STEP) {
+            for (int v = TUNE_SV_RANGE_STEP; v <= TUNE_SV_RANGE_MAX; v += TUNE_SV_RANGE_STEP) {
+                candidate.hueRange = h;
+                candidate.saturationRange = s;
+                candidate.valueRange = v;
+                candidates.push_back(candidate);
+            }
+        }
+    }
+
+    //every candidate gets its own version so the classifier tables are rebuilt
+    for (int i = 0; i < candidates.size(); i++) {
+        candidates[i].version = i + 1;
+    }
+}
+
+/*
+ * Returns the number of candidates.
+ */
+int parameterTuner::getNumCandidates() {
+    return candidates.size();
+}
+
+/*
+ * Returns the candidate at the given index.
+ */
+trackerSettings parameterTuner::getCandidate(int index) {
+    return candidates[index];
+}
+
+/*
+ * Scores the candidate at the given index.  For every sample, the 
+ * frame's cached grayscale or HSV version is classified, cleaned 
+ * up and its largest blob compared to the sample.  A frame where 
+ * nothing is found costs as much as the diagonal of the frame. 
+ * Returns the average distance, lower is better.
+ */
+float parameterTuner::evaluate(int index, tuningWorkspace& workspace) {
+    const trackerSettings& candidate = candidates[index];
+    workspace.classifier.update(candidate);
+
+    float total = 0;
+    for (int i = 0; i < samples.size(); i++) {
+        if (candidate.mode == LIGHT) workspace.classifier.classifyGray(grays[samples[i].frame], workspace.mask);
+        else {workspace.classifier.classifyHsv(hsvs[samples[i].frame], workspace.mask);}
+        workspace.filter.dilate(workspace.mask);
+        workspace.filter.blurThreshold(workspace.mask, MASK_BLUR_RADIUS, MASK_THRESHOLD);
+
+        if (workspace.finder.find(workspace.mask, minArea, maxArea, 1) > 0) {
+            float dx = workspace.finder.blobs[0].x - samples[i].x;
+            float dy = workspace.finder.blobs[0].y - samples[i].y;
+            total += std::min((float)sqrt(dx * dx + dy * dy), missPenalty);
+        }
+        else {
+            total += missPenalty;
+        }
+    }
+    return total / samples.size();
+}
@@ -0,0 +1,76 @@
+/*
+ * parameterTuner.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Finds the tracker settings that work best on 
+ * recorded frames with known target positions.  Candidate 
+ * settings are scored by how far the target they find is from 
+ * where it really is.  The grayscale and HSV versions of every 
+ * frame are made once and shared by all candidates, and 
+ * candidates can be evaluated from several threads at once, 
+ * each with its own workspace.
+ *
+ */
+
+#ifndef _PARAMETER_TUNER_H
+#define _PARAMETER_TUNER_H
+
+#include "trackerCore.h"
+
+//candidate grid
+#define TUNE_THRESHOLD_STEP 5
+#define TUNE_HUE_RANGE_STEP 5
+#define TUNE_HUE_RANGE_MAX 40
+#define TUNE_SV_RANGE_STEP 10
+#define TUNE_SV_RANGE_MAX 80
+
+/*
+ * A known target position in one of the frames.
+ */
+struct tuningSample {
+    int frame;
+    float x, y;
+};
+
+/*
+ * What a thread needs to evaluate candidates.
+ */
+struct tuningWorkspace {
+    void allocate(int width, int height) {
+        mask.allocate(width, height, 1);
+        filter.allocate(width, height);
+        finder.allocate(width, height);
+    }
+
+    imageBuffer mask;
+    pixelClassifier classifier;
+    maskFilter filter;
+    blobFinder finder;
+};
+
+class parameterTuner {
+
+    public:
+
+        parameterTuner();
+
+        void setup(const std::vector<imageBuffer>& frames, const std::vector<tuningSample>& _samples, const trackerSettings& base);
+        int getNumCandidates();
+        trackerSettings getCandidate(int index);
+        float evaluate(int index, tuningWorkspace& workspace);
+
+        int width, height;
+
+    private:
+
+        std::vector<imageBuffer> grays, hsvs;
+        std::vector<tuningSample> samples;
+        std::vector<trackerSettings> candidates;
+        int minArea, maxArea;
+        float missPenalty;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * pipelineBenchmark.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Times the specialized pipelines against the 
+ * generic stages on the same frame, for LIGHT and MANUAL mode. 
+ * Also checks that both find the same target.
+ *
+ */
+
+#include "pipelineBenchmark.h"
+#include <time.h>
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+
+/*
+ * Returns the wall clock time in microseconds.  The source threads 
+ * run while the benchmark does, so process time would count their 
+ * work too.  clock() is already wall time on Windows.
+ */
+static double wallMicros() {
+#ifndef _WIN32
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return (double)now.tv_sec * 1000000 + now.tv_usec;
+#else
+    return (double)clock() * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
+/*
+ * Default constructor.
+ */
+pipelineBenchmark::pipelineBenchmark() {
+    genericLight = specializedLight = 0;
+    genericColor = specializedColor = 0;
+    agree = true;
+}
+
+/*
+ * Runs the given frame through both kinds of pipeline the given 
+ * number of times, in both modes.  Times are in microseconds 
+ * per frame.  Both keep their images, so the same work is timed.
+ */
+void pipelineBenchmark::run(const imageBuffer& frame, const trackerSettings& settings, int frames) {
+    trackerCore generic, specialized;
+    generic.setup(frame.width, frame.height);
+    specialized.setup(frame.width, frame.height);
+    generic.setSpecialized(false);
+    generic.setDebug(true);
+    specialized.setDebug(true);
+    agree = true;
+
+    trackerSettings light = settings;
+    light.mode = LIGHT;
+    genericLight = time(generic, frame, light, frames);
+    specializedLight = time(specialized, frame, light, frames);
+    agree = agree && generic.hasTarget() == specialized.hasTarget() &&
+        generic.getX() == specialized.getX() && generic.getY() == specialized.getY();
+
+    trackerSettings color = settings;
+    color.mode = MANUAL;
+    genericColor = time(generic, frame, color, frames);
+    specializedColor = time(specialized, frame, color, frames);
+    agree = agree && generic.hasTarget() == specialized.hasTarget() &&
+        generic.getX() == specialized.getX() && generic.getY() == specialized.getY();
+}
+
+/*
+ * Returns the average time, in microseconds, the core takes to 
+ * process the frame.
+ */
+double pipelineBenchmark::time(trackerCore& core, const imageBuffer& frame, const trackerSettings& settings, int frames) {
+    double start = wallMicros();
+    for (int i = 0; i < frames; i++) {
+        core.process(frame.getPixels(), frame.width, frame.height, frame.stride, true, settings);
+    }
+    return (wallMicros() - start) / frames;
+}
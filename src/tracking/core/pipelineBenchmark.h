@@ -0,0 +1,38 @@
+/*
+ * pipelineBenchmark.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Times the specialized pipelines against the 
+ * generic stages on the same frame, for LIGHT and MANUAL mode. 
+ * Also checks that both find the same target.
+ *
+ */
+
+#ifndef _PIPELINE_BENCHMARK_H
+#define _PIPELINE_BENCHMARK_H
+
+#include "trackerCore.h"
+
+#define BENCHMARK_FRAMES 200
+
+class pipelineBenchmark {
+
+    public:
+
+        pipelineBenchmark();
+
+        void run(const imageBuffer& frame, const trackerSettings& settings, int frames);
+
+        double genericLight, specializedLight;
+        double genericColor, specializedColor;
+        bool agree;
+
+    private:
+
+        double time(trackerCore& core, const imageBuffer& frame, const trackerSettings& settings, int frames);
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * pixelClassifier.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Decides which pixels of a frame belong to 
+ * the target.  In LIGHT mode a pixel matches if it is brighter 
+ * than the threshold, in MANUAL mode if its hue, saturation 
+ * and value are within range of the target color.  Matching 
+ * pixels are set to 255 in the mask, all others to 0.
+ *
+ */
+
+#include "pixelClassifier.h"
+#include <stdlib.h>
+
+/*
+ * Default constructor.
+ */
+pixelClassifier::pixelClassifier() {
+    built = false;
+    version = 0;
+}
+
+/*
+ * Brings the lookup tables up to date with the given settings.  
+ * They are only rebuilt when the settings' version has moved.
+ */
+void pixelClassifier::update(const trackerSettings& settings) {
+    if (!built || settings.version != version) rebuildTables(settings);
+}
+
+/*
+ * Rebuilds the lookup tables.  Each table says whether a 
+ * brightness, hue, saturation or value matches the target.
+ */
+void pixelClassifier::rebuildTables(const trackerSettings& settings) {
+    for (int i = 0; i < 256; i++) {
+        lightMatch[i] = i > settings.threshold ? 255 : 0;
+
+        // since hue is cyclical:
+        int hueDiff = i - settings.hue;
+        if (hueDiff < -127) hueDiff += 255;
+        if (hueDiff > 127) hueDiff -= 255;
+
+        hueMatch[i] = abs(hueDiff) < settings.hueRange ? 255 : 0;
+        saturationMatch[i] = (i > settings.saturation - settings.saturationRange && i < settings.saturation + settings.saturationRange) ? 255 : 0;
+        valueMatch[i] = (i > settings.value - settings.valueRange && i < settings.value + settings.valueRange) ? 255 : 0;
+    }
+    version = settings.version;
+    built = true;
+}
+
+/*
+ * Converts the frame to grayscale and marks every pixel brighter 
+ * than the threshold.
+ */
+void pixelClassifier::classifyLight(const imageBuffer& rgb, imageBuffer& gray, imageBuffer& mask) {
+    for (int y = 0; y < rgb.height; y++) {
+        const unsigned char* src = rgb.getRow(y);
+        unsigned char* grayRow = gray.getRow(y);
+        unsigned char* maskRow = mask.getRow(y);
+        for (int x = 0; x < rgb.width; x++) {
+            maskRow[x] = light(src + x * 3, grayRow + x);
+        }
+    }
+}
+
+/*
+ * Converts the frame to HSV and marks every pixel whose hue, 
+ * saturation and value are all in range.
+ */
+void pixelClassifier::classifyColor(const imageBuffer& rgb, imageBuffer& hsv, imageBuffer& mask) {
+    for (int y = 0; y < rgb.height; y++) {
+        const unsigned char* src = rgb.getRow(y);
+        unsigned char* hsvRow = hsv.getRow(y);
+        unsigned char* maskRow = mask.getRow(y);
+        for (int x = 0; x < rgb.width; x++) {
+            maskRow[x] = color(src + x * 3, hsvRow + x * 3);
+        }
+    }
+}
+
+/*
+ * Marks every pixel of an already converted grayscale frame that 
+ * is brighter than the threshold.
+ */
+void pixelClassifier::classifyGray(const imageBuffer& gray, imageBuffer& mask) {
+    for (int y = 0; y < gray.height; y++) {
+        const unsigned char* grayRow = gray.getRow(y);
+        unsigned char* maskRow = mask.getRow(y);
+        for (int x = 0; x < gray.width; x++) {
+            maskRow[x] = lightMatch[grayRow[x]];
+        }
+    }
+}
+
+/*
+ * Marks every pixel of an already converted HSV frame whose hue, 
+ * saturation and value are all in range.
+ */
+void pixelClassifier::classifyHsv(const imageBuffer& hsv, imageBuffer& mask) {
+    for (int y = 0; y < hsv.height; y++) {
+        const unsigned char* hsvRow = hsv.getRow(y);
+        unsigned char* maskRow = mask.getRow(y);
+        for (int x = 0; x < hsv.width; x++) {
+            const unsigned char* p = hsvRow + x * 3;
+            maskRow[x] = hueMatch[p[0]] & saturationMatch[p[1]] & valueMatch[p[2]];
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * pixelClassifier.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Decides which pixels of a frame belong to 
+ * the target.  In LIGHT mode a pixel matches if it is brighter 
+ * than the threshold, in MANUAL mode if its hue, saturation 
+ * and value are within range of the target color.  Matching 
+ * pixels are set to 255 in the mask, all others to 0.
+ *
+ */
+
+#ifndef _PIXEL_CLASSIFIER_H
+#define _PIXEL_CLASSIFIER_H
+
+#include "imageBuffer.h"
+#include "trackerSettings.h"
+#include "colorConversion.h"
+
+class pixelClassifier {
+
+    public:
+
+        pixelClassifier();
+
+        void update(const trackerSettings& settings);
+        void classifyLight(const imageBuffer& rgb, imageBuffer& gray, imageBuffer& mask);
+        void classifyColor(const imageBuffer& rgb, imageBuffer& hsv, imageBuffer& mask);
+        void classifyGray(const imageBuffer& gray, imageBuffer& mask);
+        void classifyHsv(const imageBuffer& hsv, imageBuffer& mask);
+
+        /*
+         * Classifies a single pixel in LIGHT mode.  Its gray value 
+         * is written to gray.
+         */
+        inline unsigned char light(const unsigned char* rgb, unsigned char* gray) const {
+            *gray = colorConversion::grayPixel(rgb);
+            return lightMatch[*gray];
+        }
+
+        /*
+         * Classifies a single pixel in MANUAL mode.  Its HSV values 
+         * are written to hsv.
+         */
+        inline unsigned char color(const unsigned char* rgb, unsigned char* hsv) const {
+            colorConversion::hsvPixel(rgb, hsv);
+            return hueMatch[hsv[0]] & saturationMatch[hsv[1]] & valueMatch[hsv[2]];
+        }
+
+    private:
+
+        void rebuildTables(const trackerSettings& settings);
+
+        bool built;
+        unsigned int version;
+        unsigned char threshold;
+        unsigned char hueMatch[256], saturationMatch[256], valueMatch[256];
+        unsigned char lightMatch[256];
+};
+
+#endif
@@ -0,0 +1,282 @@
+/*
+ * sampleRing.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Publishes tracker samples to other processes 
+ * through a ring in POSIX shared memory.  There is one writer 
+ * and any number of readers, and neither ever locks.  Every slot 
+ * carries a stamp that is odd while the writer is filling it in; 
+ * a reader copies a slot and checks that the stamp didn't change 
+ * while it did.  Reading a sample is a plain memory read, with 
+ * no system calls.
+ *
+ */
+
+#include "sampleRing.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Makes sure the reads and writes before it are done before 
+ * the ones after it, for the compiler and the processor.
+ */
+static inline void memoryBarrier() {
+#ifndef _WIN32
+    __sync_synchronize();
+#endif
+}
+
+/*
+ * Default constructor.
+ */
+sampleRingWriter::sampleRingWriter() {
+    header = 0;
+    slots = 0;
+    size = 0;
+}
+
+/*
+ * Deleting the writer.  Removes the shared memory.
+ */
+sampleRingWriter::~sampleRingWriter() {
+    close();
+}
+
+/*
+ * Creates the shared memory with the given name, i.e. "/flashtrack", 
+ * with room for the given number of samples.  Readers that come 
+ * too late to read a sample before it is overwritten lose it. 
+ * Returns false if the memory couldn't be made, or there would be 
+ * no room for a sample.
+ */
+bool sampleRingWriter::create(std::string _name, int capacity) {
+#ifndef _WIN32
+    close();
+    if (capacity < 1) return false;
+    name = _name;
+    size = sizeof(sampleRingHeader) + capacity * sizeof(sampleSlot);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, size) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    header = (sampleRingHeader*)memory;
+    slots = (sampleSlot*)(header + 1);
+    for (int i = 0; i < capacity; i++) {
+        slots[i].stamp = 0;
+    }
+    header->capacity = capacity;
+    header->slotSize = sizeof(sampleSlot);
+    header->version = SAMPLE_RING_VERSION;
+    header->written = 0;
+    //readers check the magic number last
+    memoryBarrier();
+    header->magic = SAMPLE_RING_MAGIC;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ * Publishes a sample.  Its sequence and timestamp are filled in. 
+ * The slot's stamp is odd while the sample is written, so readers 
+ * can tell if they raced with the writer.
+ */
+void sampleRingWriter::publish(trackerSample& sample) {
+#ifndef _WIN32
+    if (header == 0) return;
+
+    struct timeval now;
+    gettimeofday(&now, 0);
+    sample.timestamp = (unsigned long long)now.tv_sec * 1000000 + now.tv_usec;
+    sample.sequence = header->written;
+
+    sampleSlot& slot = slots[sample.sequence % header->capacity];
+    slot.stamp = sample.sequence * 2 + 1;
+    memoryBarrier();
+    slot.sample = sample;
+    memoryBarrier();
+    slot.stamp = sample.sequence * 2 + 2;
+    //readers must see the stamp before the sample counts as written
+    memoryBarrier();
+    header->written = sample.sequence + 1;
+#endif
+}
+
+/*
+ * Unmaps and removes the shared memory.  Readers that still 
+ * have it mapped keep their view of it.
+ */
+void sampleRingWriter::close() {
+#ifndef _WIN32
+    if (header == 0) return;
+    munmap(header, size);
+    shm_unlink(name.c_str());
+    header = 0;
+    slots = 0;
+#endif
+}
+
+/*
+ * Returns if the ring has been created.
+ */
+bool sampleRingWriter::isOpen() {
+    return header != 0;
+}
+
+/*
+ * Default constructor.
+ */
+sampleRingReader::sampleRingReader() {
+    header = 0;
+    slots = 0;
+    size = 0;
+    cursor = lost = 0;
+}
+
+/*
+ * Deleting the reader.
+ */
+sampleRingReader::~sampleRingReader() {
+    close();
+}
+
+/*
+ * Maps the shared memory with the given name read only.  Reading 
+ * starts with the next sample published.  Returns false if there 
+ * is no ring by that name, or it isn't one this reader understands.
+ */
+bool sampleRingReader::open(std::string name) {
+#ifndef _WIN32
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(sampleRingHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size = info.st_size;
+    void* memory = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    header = (const sampleRingHeader*)memory;
+    slots = (const sampleSlot*)(header + 1);
+    memoryBarrier();
+    if (header->magic != SAMPLE_RING_MAGIC || header->version != SAMPLE_RING_VERSION ||
+        header->slotSize != sizeof(sampleSlot) ||
+        sizeof(sampleRingHeader) + header->capacity * sizeof(sampleSlot) > (size_t)size) {
+        close();
+        return false;
+    }
+    cursor = header->written;
+    lost = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ * Reads the next sample in order.  Returns false if there is no 
+ * new one yet.  If the writer got more than a ring ahead, the 
+ * samples that were overwritten are skipped and counted as lost.
+ */
+bool sampleRingReader::next(trackerSample& sample) {
+    if (header == 0) return false;
+    while (true) {
+        unsigned int written = header->written;
+        memoryBarrier();
+        if (cursor == written) return false;
+        if (written - cursor > header->capacity) {
+            lost += written - header->capacity - cursor;
+            cursor = written - header->capacity;
+        }
+        if (read(cursor, sample)) {
+            cursor++;
+            return true;
+        }
+        //overwritten while reading it
+        lost++;
+        cursor++;
+    }
+}
+
+/*
+ * Reads the newest sample, skipping anything older.  Returns 
+ * false if nothing has been published yet.
+ */
+bool sampleRingReader::latest(trackerSample& sample) {
+    if (header == 0) return false;
+    while (true) {
+        unsigned int written = header->written;
+        memoryBarrier();
+        if (written == 0) return false;
+        if (read(written - 1, sample)) {
+            cursor = written;
+            return true;
+        }
+    }
+}
+
+/*
+ * Returns the number of samples skipped by next() because the 
+ * writer overwrote them first.
+ */
+unsigned int sampleRingReader::getLost() {
+    return lost;
+}
+
+/*
+ * Unmaps the shared memory.
+ */
+void sampleRingReader::close() {
+#ifndef _WIN32
+    if (header == 0) return;
+    munmap((void*)header, size);
+    header = 0;
+    slots = 0;
+#endif
+}
+
+/*
+ * Returns if a ring is open.
+ */
+bool sampleRingReader::isOpen() {
+    return header != 0;
+}
+
+/*
+ * Copies the sample with the given sequence number.  Returns 
+ * false if the slot holds another sample or was being written 
+ * while it was copied.
+ */
+bool sampleRingReader::read(unsigned int sequence, trackerSample& sample) {
+    const sampleSlot& slot = slots[sequence % header->capacity];
+    unsigned int before = slot.stamp;
+    memoryBarrier();
+    sample = *(const trackerSample*)&slot.sample;
+    memoryBarrier();
+    return before == sequence * 2 + 2 && slot.stamp == before;
+}
@@ -0,0 +1,96 @@
+/*
+ * sampleRing.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Publishes tracker samples to other processes 
+ * through a ring in POSIX shared memory.  There is one writer 
+ * and any number of readers, and neither ever locks.  Every slot 
+ * carries a stamp that is odd while the writer is filling it in; 
+ * a reader copies a slot and checks that the stamp didn't change 
+ * while it did.  Reading a sample is a plain memory read, with 
+ * no system calls.
+ *
+ */
+
+#ifndef _SAMPLE_RING_H
+#define _SAMPLE_RING_H
+
+#include <string>
+
+#define SAMPLE_RING_MAGIC 0x464c5452
+#define SAMPLE_RING_VERSION 1
+#define SAMPLE_RING_CAPACITY 1024
+
+/*
+ * A sample of the tracker.  The timestamp is in microseconds 
+ * since the epoch, positions are in screen coordinates and the 
+ * confidence goes from 0 to 1.
+ */
+struct trackerSample {
+    unsigned long long timestamp;
+    unsigned int sequence;
+    int found;
+    float x, y, area, confidence;
+};
+
+/*
+ * What is at the start of the shared memory.  The slots follow.
+ */
+struct sampleRingHeader {
+    unsigned int magic, version, capacity, slotSize;
+    volatile unsigned int written;
+};
+
+struct sampleSlot {
+    volatile unsigned int stamp;
+    trackerSample sample;
+};
+
+class sampleRingWriter {
+
+    public:
+
+        sampleRingWriter();
+        virtual ~sampleRingWriter();
+
+        bool create(std::string _name, int capacity);
+        void publish(trackerSample& sample);
+        void close();
+        bool isOpen();
+
+    private:
+
+        std::string name;
+        sampleRingHeader* header;
+        sampleSlot* slots;
+        int size;
+};
+
+class sampleRingReader {
+
+    public:
+
+        sampleRingReader();
+        virtual ~sampleRingReader();
+
+        bool open(std::string name);
+        bool next(trackerSample& sample);
+        bool latest(trackerSample& sample);
+        unsigned int getLost();
+        void close();
+        bool isOpen();
+
+    private:
+
+        bool read(unsigned int sequence, trackerSample& sample);
+
+        const sampleRingHeader* header;
+        const sampleSlot* slots;
+        int size;
+        unsigned int cursor, lost;
+};
+
+#endif
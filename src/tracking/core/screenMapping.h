@@ -0,0 +1,43 @@
+/*
+ * screenMapping.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Maps positions in a camera frame into the 
+ * part of the screen that the camera covers.  The area is 
+ * normalized, i.e. (0, 0, 1, 1) is the whole screen.
+ *
+ */
+
+#ifndef _SCREEN_MAPPING_H
+#define _SCREEN_MAPPING_H
+
+class screenMapping {
+
+    public:
+
+        /*
+         * Constructor setting the normalized area of the screen.
+         */
+        screenMapping(float _x = 0, float _y = 0, float _width = 1, float _height = 1) {
+            x = _x;
+            y = _y;
+            width = _width;
+            height = _height;
+        }
+
+        /*
+         * Maps the camera position (camX, camY) in a frame of the 
+         * given size to screen pixels.
+         */
+        void map(float camX, float camY, int camWidth, int camHeight, int screenWidth, int screenHeight, float& screenX, float& screenY) const {
+            screenX = (x + (camX / camWidth) * width) * screenWidth;
+            screenY = (y + (camY / camHeight) * height) * screenHeight;
+        }
+
+        float x, y, width, height;
+};
+
+#endif
@@ -0,0 +1,301 @@
+/*
+ * trackerCore.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The tracking pipeline for one frame source.  
+ * Takes plain frames in memory and finds the target in them. 
+ * Doesn't depend on openFrameworks, so it can be run without 
+ * a window or a camera.  The frame and its converted versions 
+ * are only kept while debugging, and only allocated once needed.
+ *
+ */
+
+#include "trackerCore.h"
+
+//the combinations of stages that have a specialized pipeline
+static specializedPipeline<directSource, lightClassifier, positionOnly, fusedCleanup, largestBlobs> directLight;
+static specializedPipeline<mirroredSource, lightClassifier, positionOnly, fusedCleanup, largestBlobs> mirroredLight;
+static specializedPipeline<directSource, colorClassifier, positionOnly, fusedCleanup, largestBlobs> directColor;
+static specializedPipeline<mirroredSource, colorClassifier, positionOnly, fusedCleanup, largestBlobs> mirroredColor;
+static specializedPipeline<directSource, lightClassifier, keepImages, fusedCleanup, largestBlobs> directLightDebug;
+static specializedPipeline<mirroredSource, lightClassifier, keepImages, fusedCleanup, largestBlobs> mirroredLightDebug;
+static specializedPipeline<directSource, colorClassifier, keepImages, fusedCleanup, largestBlobs> directColorDebug;
+static specializedPipeline<mirroredSource, colorClassifier, keepImages, fusedCleanup, largestBlobs> mirroredColorDebug;
+
+/*
+ * Default constructor.
+ */
+trackerCore::trackerCore() {
+    width = height = 0;
+    minArea = maxArea = 0;
+    found = false;
+    targetX = targetY = targetArea = 0;
+    pipeline = 0;
+    pipelineMode = -1;
+    pipelineMirror = false;
+    pipelineDebug = false;
+    specialized = true;
+    debug = false;
+}
+
+/*
+ * Allocates the pipeline for frames of the given size.  Only what 
+ * every mode needs is allocated here, the rest once it is used.
+ */
+void trackerCore::setup(int _width, int _height) {
+    width = _width;
+    height = _height;
+
+    minArea = 2;
+    maxArea = (int)(width * height * .33);
+
+    mask.allocate(width, height, 1);
+    row.allocate(width, 1, 3);
+    filter.allocate(width, height);
+    finder.allocate(width, height);
+    shift.setup(width, height);
+
+    stages.color = &color;
+    stages.gray = &gray;
+    stages.hsv = &hsv;
+    stages.mask = &mask;
+    stages.row = &row;
+    stages.classifier = &classifier;
+    stages.filter = &filter;
+    stages.finder = &finder;
+    stages.minArea = minArea;
+    stages.maxArea = maxArea;
+    stages.maxBlobs = MAX_BLOBS;
+}
+
+/*
+ * Processes a frame given as a pointer to RGB pixels, its size and 
+ * its stride.  The frame is copied in, scaled to the pipeline's size 
+ * and mirrored if asked.  Depending on the mode, the pixels matching 
+ * the settings are masked, cleaned up and their largest blob is 
+ * taken as the target, or the target histogram is followed with 
+ * CamShift.  Frames of the core's own size go through a specialized 
+ * pipeline when there is one for the mode.
+ */
+void trackerCore::process(const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror, const trackerSettings& settings) {
+    if (settings.mode != pipelineMode || mirror != pipelineMirror || debug != pipelineDebug) {
+        pipeline = selectPipeline(settings.mode, mirror, debug);
+        pipelineMode = settings.mode;
+        pipelineMirror = mirror;
+        pipelineDebug = debug;
+    }
+
+    if (pipeline != 0 && specialized && srcWidth == width && srcHeight == height) {
+        if (debug) {
+            require(color, 3);
+            if (settings.mode == LIGHT) require(gray, 1);
+            else {require(hsv, 3);}
+        }
+        classifier.update(settings);
+        found = pipeline->run(stages, pixels, srcStride) > 0;
+        if (found) {
+            targetX = finder.blobs[0].x;
+            targetY = finder.blobs[0].y;
+            targetArea = finder.blobs[0].area;
+        }
+        return;
+    }
+
+    require(color, 3);
+    if (settings.mode == LIGHT) require(gray, 1);
+    else {require(hsv, 3);}
+    color.copyFrom(pixels, srcWidth, srcHeight, srcStride, mirror);
+
+    if (settings.mode == CAMSHIFT) {
+        finder.blobs.clear();
+        found = settings.hasHistogram && shift.track(color, hsv, settings.histogram);
+        if (found) {
+            targetX = shift.targetX;
+            targetY = shift.targetY;
+            targetArea = shift.targetArea;
+        }
+        return;
+    }
+
+    classifier.update(settings);
+    if (settings.mode == LIGHT) classifier.classifyLight(color, gray, mask);
+    else {classifier.classifyColor(color, hsv, mask);}
+
+    filter.clean(mask);
+
+    found = finder.find(mask, minArea, maxArea, MAX_BLOBS) > 0;
+    if (found) {
+        targetX = finder.blobs[0].x;
+        targetY = finder.blobs[0].y;
+        targetArea = finder.blobs[0].area;
+    }
+}
+
+/*
+ * Picks the specialized pipeline for the given mode and source, 
+ * keeping the images or not.  Returns 0 if there is none, in 
+ * which case the generic stages are used.
+ */
+trackerPipeline* trackerCore::selectPipeline(int mode, bool mirror, bool keep) {
+    if (keep) {
+        if (mode == LIGHT) return mirror ? (trackerPipeline*)&mirroredLightDebug : (trackerPipeline*)&directLightDebug;
+        if (mode == MANUAL) return mirror ? (trackerPipeline*)&mirroredColorDebug : (trackerPipeline*)&directColorDebug;
+        return 0;
+    }
+    if (mode == LIGHT) return mirror ? (trackerPipeline*)&mirroredLight : (trackerPipeline*)&directLight;
+    if (mode == MANUAL) return mirror ? (trackerPipeline*)&mirroredColor : (trackerPipeline*)&directColor;
+    return 0;
+}
+
+/*
+ * Allocates the given buffer at the core's size if it hasn't 
+ * been yet.
+ */
+void trackerCore::require(imageBuffer& buffer, int channels) {
+    if (!buffer.isAllocated()) buffer.allocate(width, height, channels);
+}
+
+/*
+ * Sets whether specialized pipelines are used.  If not, every 
+ * frame goes through the generic stages one after another.
+ */
+void trackerCore::setSpecialized(bool _specialized) {
+    specialized = _specialized;
+}
+
+/*
+ * Sets whether the frame and its converted versions are kept so 
+ * they can be shown.  When debugging stops, they are freed; the 
+ * generic stages and CamShift allocate them again if they need to.
+ */
+void trackerCore::setDebug(bool _debug) {
+    if (debug && !_debug) {
+        color.release();
+        gray.release();
+        hsv.release();
+    }
+    debug = _debug;
+}
+
+/*
+ * Returns if the target was found in the last frame.
+ */
+bool trackerCore::hasTarget() {
+    return found;
+}
+
+/*
+ * Returns the x position of the target in the last frame it 
+ * was found in.
+ */
+float trackerCore::getX() {
+    return targetX;
+}
+
+/*
+ * Returns the y position of the target in the last frame it 
+ * was found in.
+ */
+float trackerCore::getY() {
+    return targetY;
+}
+
+/*
+ * Returns the area of the target in the last frame it was 
+ * found in.
+ */
+float trackerCore::getArea() {
+    return targetArea;
+}
+
+/*
+ * Returns how sure the core is of the target in the last frame, 
+ * from 0 to 1.  That is the share of all the matching area that 
+ * the target has, or 1 for CamShift, which only has one.
+ */
+float trackerCore::getConfidence() {
+    if (!found) return 0;
+    if (finder.blobs.empty()) return 1;
+    float total = 0;
+    for (int i = 0; i < finder.blobs.size(); i++) {
+        total += finder.blobs[i].area;
+    }
+    return finder.blobs[0].area / total;
+}
+
+/*
+ * Returns the blobs found in the last frame, largest first.
+ */
+const std::vector<blob>& trackerCore::getBlobs() {
+    return finder.blobs;
+}
+
+/*
+ * Gets the HSV values of the pixel at the given position of 
+ * the last frame.  Returns false if the frame wasn't kept.
+ */
+bool trackerCore::getHsvAt(int x, int y, unsigned char* _hsv) {
+    if (!color.isAllocated()) return false;
+    colorConversion::hsvPixel(color.getRow(y) + x * 3, _hsv);
+    return true;
+}
+
+/*
+ * Builds a CamShift histogram from the area around the given 
+ * position of the last frame.  Returns false if there was nothing 
+ * to build it from, or the frame wasn't kept.
+ */
+bool trackerCore::buildHistogram(int x, int y, unsigned char* histogram) {
+    if (!color.isAllocated()) return false;
+    require(hsv, 3);
+    return shift.buildHistogram(color, hsv, x, y, histogram);
+}
+
+/*
+ * Makes the CamShift search window cover the whole frame.
+ */
+void trackerCore::resetSearchWindow() {
+    shift.resetWindow();
+}
+
+/*
+ * Returns the last frame.  Only kept while debugging, or in 
+ * CAMSHIFT mode and when the generic stages are used.
+ */
+imageBuffer& trackerCore::getColor() {
+    return color;
+}
+
+/*
+ * Returns the grayscale version of the last frame.  Only 
+ * up to date in LIGHT mode, and only kept while debugging.
+ */
+imageBuffer& trackerCore::getGray() {
+    return gray;
+}
+
+/*
+ * Returns the HSV version of the last frame.  Only up to date 
+ * in MANUAL mode, and around the search window in CAMSHIFT mode.
+ */
+imageBuffer& trackerCore::getHsv() {
+    return hsv;
+}
+
+/*
+ * Returns the cleaned up mask of the pixels that matched the 
+ * settings in the last frame.
+ */
+imageBuffer& trackerCore::getMask() {
+    return mask;
+}
+
+/*
+ * Returns the CamShift tracker.
+ */
+camShift& trackerCore::getCamShift() {
+    return shift;
+}
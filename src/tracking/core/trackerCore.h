@@ -0,0 +1,81 @@
+/*
+ * trackerCore.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The tracking pipeline for one frame source.  
+ * Takes plain frames in memory and finds the target in them. 
+ * Doesn't depend on openFrameworks, so it can be run without 
+ * a window or a camera.
+ *
+ */
+
+#ifndef _TRACKER_CORE_H
+#define _TRACKER_CORE_H
+
+#include "imageBuffer.h"
+#include "trackerSettings.h"
+#include "colorConversion.h"
+#include "pixelClassifier.h"
+#include "maskFilter.h"
+#include "blobFinder.h"
+#include "camShift.h"
+#include "trackerPipeline.h"
+#include "screenMapping.h"
+
+#define MAX_BLOBS 10
+
+class trackerCore {
+
+    public:
+
+        trackerCore();
+
+        void setup(int _width, int _height);
+        void process(const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror, const trackerSettings& settings);
+
+        bool hasTarget();
+        float getX();
+        float getY();
+        float getArea();
+        float getConfidence();
+        const std::vector<blob>& getBlobs();
+
+        bool getHsvAt(int x, int y, unsigned char* hsv);
+        bool buildHistogram(int x, int y, unsigned char* histogram);
+        void resetSearchWindow();
+        void setSpecialized(bool _specialized);
+        void setDebug(bool _debug);
+
+        imageBuffer& getColor();
+        imageBuffer& getGray();
+        imageBuffer& getHsv();
+        imageBuffer& getMask();
+        camShift& getCamShift();
+
+        int width, height;
+
+    private:
+
+        trackerPipeline* selectPipeline(int mode, bool mirror, bool keep);
+        void require(imageBuffer& buffer, int channels);
+
+        imageBuffer color, gray, hsv, mask, row;
+        pixelClassifier classifier;
+        maskFilter filter;
+        blobFinder finder;
+        camShift shift;
+
+        pipelineStages stages;
+        trackerPipeline* pipeline;
+        int pipelineMode;
+        bool pipelineMirror, pipelineDebug, specialized, debug;
+
+        int minArea, maxArea;
+        bool found;
+        float targetX, targetY, targetArea;
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * trackerPipeline.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Pipelines specialized at compile time.  Each 
+ * stage of the tracker core (reading the source, classifying 
+ * pixels, cleaning up the mask and extracting blobs) is a policy 
+ * class, and a pipeline is built from one policy per stage.  The 
+ * compiler can then fuse the stages and inline the per pixel 
+ * work.  Whether the frame and its converted versions are kept 
+ * for display is a policy as well.  The tracker core picks a 
+ * pipeline once when the mode, the source or that changes.
+ *
+ */
+
+#ifndef _TRACKER_PIPELINE_H
+#define _TRACKER_PIPELINE_H
+
+#include "imageBuffer.h"
+#include "pixelClassifier.h"
+#include "maskFilter.h"
+#include "blobFinder.h"
+
+/*
+ * The buffers and stages of a tracker core that a pipeline 
+ * works on.
+ */
+struct pipelineStages {
+    imageBuffer* color;
+    imageBuffer* gray;
+    imageBuffer* hsv;
+    imageBuffer* mask;
+    imageBuffer* row;
+    pixelClassifier* classifier;
+    maskFilter* filter;
+    blobFinder* finder;
+    int minArea, maxArea, maxBlobs;
+};
+
+class trackerPipeline {
+
+    public:
+
+        virtual ~trackerPipeline() {}
+
+        /*
+         * Runs the pipeline on a frame of the core's size.  Returns 
+         * the number of blobs found.
+         */
+        virtual int run(pipelineStages& stages, const unsigned char* pixels, int srcStride) = 0;
+};
+
+/*
+ * Source policies.  Return the pixel at x of a source row.
+ */
+struct directSource {
+    static inline const unsigned char* pixel(const unsigned char* row, int x, int) {
+        return row + x * 3;
+    }
+};
+
+struct mirroredSource {
+    static inline const unsigned char* pixel(const unsigned char* row, int x, int width) {
+        return row + (width - 1 - x) * 3;
+    }
+};
+
+/*
+ * Classifier policies.  Classify a pixel and write its 
+ * converted value to the core's buffer for that mode.
+ */
+struct lightClassifier {
+    static inline imageBuffer* output(pipelineStages& stages) {
+        return stages.gray;
+    }
+    static inline unsigned char classify(const pixelClassifier& c, const unsigned char* rgb, unsigned char* out, int x) {
+        return c.light(rgb, out + x);
+    }
+};
+
+struct colorClassifier {
+    static inline imageBuffer* output(pipelineStages& stages) {
+        return stages.hsv;
+    }
+    static inline unsigned char classify(const pixelClassifier& c, const unsigned char* rgb, unsigned char* out, int x) {
+        return c.color(rgb, out + x * 3);
+    }
+};
+
+/*
+ * Retention policies.  Whether the frame and its converted 
+ * version are kept, or only the mask is made.
+ */
+struct keepImages {
+    static const bool keep = true;
+};
+
+struct positionOnly {
+    static const bool keep = false;
+};
+
+/*
+ * Cleanup policies.
+ */
+struct fusedCleanup {
+    static inline void clean(maskFilter& filter, imageBuffer& mask) {
+        filter.dilate(mask);
+        filter.blurThreshold(mask, MASK_BLUR_RADIUS, MASK_THRESHOLD);
+    }
+};
+
+/*
+ * Blob extraction policies.
+ */
+struct largestBlobs {
+    static inline int extract(pipelineStages& stages) {
+        return stages.finder->find(*stages.mask, stages.minArea, stages.maxArea, stages.maxBlobs);
+    }
+};
+
+/*
+ * A pipeline built from one policy per stage.  Reading the source, 
+ * keeping a copy of the frame and classifying its pixels are done 
+ * in a single pass.  If the images aren't kept, pixels are 
+ * classified straight from the source and the converted values 
+ * go to a single row that is overwritten every time.
+ */
+template <class Source, class Classifier, class Retention, class Cleanup, class Extractor>
+class specializedPipeline : public trackerPipeline {
+
+    public:
+
+        int run(pipelineStages& stages, const unsigned char* pixels, int srcStride) {
+            imageBuffer& mask = *stages.mask;
+            imageBuffer& out = Retention::keep ? *Classifier::output(stages) : *stages.row;
+            const pixelClassifier& classifier = *stages.classifier;
+            int w = mask.width;
+
+            for (int y = 0; y < mask.height; y++) {
+                const unsigned char* srcRow = pixels + y * srcStride;
+                unsigned char* outRow = out.getRow(Retention::keep ? y : 0);
+                unsigned char* maskRow = mask.getRow(y);
+                if (Retention::keep) {
+                    unsigned char* colorRow = stages.color->getRow(y);
+                    for (int x = 0; x < w; x++) {
+                        const unsigned char* p = Source::pixel(srcRow, x, w);
+                        colorRow[x*3] = p[0];
+                        colorRow[x*3+1] = p[1];
+                        colorRow[x*3+2] = p[2];
+                        maskRow[x] = Classifier::classify(classifier, colorRow + x * 3, outRow, x);
+                    }
+                }
+                else {
+                    for (int x = 0; x < w; x++) {
+                        maskRow[x] = Classifier::classify(classifier, Source::pixel(srcRow, x, w), outRow, x);
+                    }
+                }
+            }
+
+            Cleanup::clean(*stages.filter, mask);
+            return Extractor::extract(stages);
+        }
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * trackerSettings.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  The parameters of the tracker, kept together 
+ * so they can be handed out and changed as one.  Every change 
+ * that is published moves the version, which lets the tracker 
+ * know when anything derived from the parameters is stale.
+ *
+ */
+
+#ifndef _TRACKER_SETTINGS_H
+#define _TRACKER_SETTINGS_H
+
+#include <string.h>
+
+//CamShift histogram settings
+#define HIST_HUE_BINS 16
+#define HIST_SAT_BINS 8
+#define HIST_BINS (HIST_HUE_BINS * HIST_SAT_BINS)
+
+enum{LIGHT, MANUAL, CAMSHIFT};
+
+struct trackerSettings {
+
+    /*
+     * Default constructor.  Sets the default parameters.
+     */
+    trackerSettings() {
+        mode = LIGHT;
+        threshold = 80;
+        hue = 0;
+        saturation = 0;
+        value = 0;
+        hueRange = 20;
+        saturationRange = 30;
+        valueRange = 25;
+        hasHistogram = false;
+        memset(histogram, 0, sizeof(histogram));
+        version = 0;
+    }
+
+    /*
+     * Returns if the given settings have the same parameters. 
+     * The version isn't compared.
+     */
+    bool sameAs(const trackerSettings& s) const {
+        return mode == s.mode && threshold == s.threshold &&
+            hue == s.hue && saturation == s.saturation && value == s.value &&
+            hueRange == s.hueRange && saturationRange == s.saturationRange && valueRange == s.valueRange &&
+            hasHistogram == s.hasHistogram && memcmp(histogram, s.histogram, sizeof(histogram)) == 0;
+    }
+
+    int mode;
+    int threshold;
+    int hue, saturation, value;
+    int hueRange, saturationRange, valueRange;
+    bool hasHistogram;
+    unsigned char histogram[HIST_BINS];
+    unsigned int version;
+};
+
+#endif
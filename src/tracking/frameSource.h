@@ -0,0 +1,155 @@
+/*
+ * frameSource.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Sources of video frames for the tracker.  
+ * A source is either a live camera or a recording that is 
+ * replayed in its place.
+ *
+ */
+
+#ifndef _FRAME_SOURCE_H
+#define _FRAME_SOURCE_H
+
+#include "ofMain.h"
+
+class frameSource {
+
+    public:
+
+        virtual ~frameSource() {}
+
+        /*
+         * Opens the source at the given size.  Returns false if 
+         * the source couldn't be opened.
+         */
+        virtual bool setup(int _width, int _height) = 0;
+
+        /*
+         * Polls the source for a new frame.
+         */
+        virtual void update() = 0;
+
+        /*
+         * Returns if the last update brought a new frame.
+         */
+        virtual bool isFrameNew() = 0;
+
+        /*
+         * Returns the pixels of the current frame.
+         */
+        virtual unsigned char* getPixels() = 0;
+
+        virtual int getWidth() = 0;
+        virtual int getHeight() = 0;
+
+        /*
+         * Closes the source.
+         */
+        virtual void close() = 0;
+};
+
+class cameraSource : public frameSource {
+
+    public:
+
+        /*
+         * Constructor setting the camera to use.
+         */
+        cameraSource(int _device = 0) {
+            device = _device;
+        }
+
+        bool setup(int _width, int _height) {
+            vidGrabber.setVerbose(true);
+            vidGrabber.setDeviceID(device);
+            return vidGrabber.initGrabber(_width, _height);
+        }
+
+        void update() {
+            vidGrabber.grabFrame();
+        }
+
+        bool isFrameNew() {
+            return vidGrabber.isFrameNew();
+        }
+
+        unsigned char* getPixels() {
+            return vidGrabber.getPixels();
+        }
+
+        int getWidth() {
+            return vidGrabber.getWidth();
+        }
+
+        int getHeight() {
+            return vidGrabber.getHeight();
+        }
+
+        void close() {
+            vidGrabber.close();
+        }
+
+    private:
+
+        ofVideoGrabber vidGrabber;
+        int device;
+};
+
+class recordingSource : public frameSource {
+
+    public:
+
+        /*
+         * Constructor setting the movie file to replay.
+         */
+        recordingSource(string _path) {
+            path = _path;
+        }
+
+        /*
+         * Loads the movie and starts looping it.  The size of the 
+         * recording is used as is.
+         */
+        bool setup(int _width, int _height) {
+            player.setUseTexture(false);
+            if (!player.loadMovie(path)) return false;
+            player.setLoopState(OF_LOOP_NORMAL);
+            player.play();
+            return true;
+        }
+
+        void update() {
+            player.idleMovie();
+        }
+
+        bool isFrameNew() {
+            return player.isFrameNew();
+        }
+
+        unsigned char* getPixels() {
+            return player.getPixels();
+        }
+
+        int getWidth() {
+            return player.getWidth();
+        }
+
+        int getHeight() {
+            return player.getHeight();
+        }
+
+        void close() {
+            player.close();
+        }
+
+    private:
+
+        ofVideoPlayer player;
+        string path;
+};
+
+#endif
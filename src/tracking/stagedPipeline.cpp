@@ -0,0 +1,285 @@
+/*
+ * stagedPipeline.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Runs the stages of the tracker core on threads 
+ * of their own, so consecutive frames overlap: while one frame 
+ * is being cleaned up, the next one is already being classified. 
+ * Frames are grabbed on the caller's thread and go through the 
+ * classify, morphology and components stages.  Throughput is 
+ * limited by the slowest stage instead of all of them together, 
+ * at the cost of results arriving a few frames later.  There is 
+ * a fixed pool of frames; when all of them are in flight, new 
+ * frames are dropped.  CamShift depends on the previous frame's 
+ * result, so it can't be staged.
+ *
+ */
+
+#include "stagedPipeline.h"
+
+/*
+ * Default constructor.  An empty queue.
+ */
+frameQueue::frameQueue() : available(0, STAGED_FRAMES + 1) {
+}
+
+/*
+ * Adds a frame to the back of the queue.  A null frame tells 
+ * the stage reading the queue to stop.
+ */
+void frameQueue::push(stagedFrame* frame) {
+    mutex.lock();
+    frames.push_back(frame);
+    mutex.unlock();
+    available.set();
+}
+
+/*
+ * Takes the frame at the front of the queue, waiting for one 
+ * if it is empty.
+ */
+stagedFrame* frameQueue::pop() {
+    available.wait();
+    mutex.lock();
+    stagedFrame* frame = frames.front();
+    frames.pop_front();
+    mutex.unlock();
+    return frame;
+}
+
+/*
+ * Takes the frame at the front of the queue, or returns null 
+ * right away if it is empty.
+ */
+stagedFrame* frameQueue::tryPop() {
+    if (!available.tryWait(0)) return 0;
+    mutex.lock();
+    stagedFrame* frame = frames.front();
+    frames.pop_front();
+    mutex.unlock();
+    return frame;
+}
+
+/*
+ * Default constructor.
+ */
+stagedPipeline::stagedPipeline() {
+    width = height = 0;
+    minArea = maxArea = 0;
+    running = false;
+}
+
+/*
+ * Deleting the pipeline.  Stops the stages.
+ */
+stagedPipeline::~stagedPipeline() {
+    stop();
+}
+
+/*
+ * Allocates the pool of frames and the stages' buffers for 
+ * frames of the given size.
+ */
+void stagedPipeline::setup(int _width, int _height) {
+    width = _width;
+    height = _height;
+    minArea = 2;
+    maxArea = (int)(width * height * .33);
+
+    for (int i = 0; i < STAGED_FRAMES; i++) {
+        frames[i].color.allocate(width, height, 3);
+        frames[i].mask.allocate(width, height, 1);
+        freeFrames.push(&frames[i]);
+    }
+    gray.allocate(width, height, 1);
+    hsv.allocate(width, height, 3);
+    filter.allocate(width, height);
+    finder.allocate(width, height);
+}
+
+/*
+ * Starts a thread for every stage.
+ */
+void stagedPipeline::start() {
+    if (running) return;
+    for (int i = 0; i < NUM_STAGES; i++) {
+        workers[i].setup(this, i);
+        workers[i].startThread(false, false);
+    }
+    running = true;
+}
+
+/*
+ * Stops the stages.  Each is woken up with a null frame once 
+ * it has been told to stop.
+ */
+void stagedPipeline::stop() {
+    if (!running) return;
+    for (int i = 0; i < NUM_STAGES; i++) {
+        workers[i].stopThread();
+        queues[i].push(0);
+        workers[i].waitForThread(false);
+    }
+    running = false;
+}
+
+/*
+ * The grab stage.  Copies the frame into a free one from the pool, 
+ * scaled and mirrored like the tracker core does, and hands it to 
+ * the classify stage along with the settings to use.  The result 
+ * carries the given grab time, in microseconds, so it can be told 
+ * which frame it belongs to.  Returns false if every frame is still 
+ * in flight, in which case this one is dropped.
+ */
+bool stagedPipeline::submit(const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror,
+                            const trackerSettings& settings, unsigned long long grabbed) {
+    if (!running) return false;
+    stagedFrame* frame = freeFrames.tryPop();
+    if (frame == 0) return false;
+    frame->result.grabbed = grabbed;
+    frame->color.copyFrom(pixels, srcWidth, srcHeight, srcStride, mirror);
+    frame->settings = settings;
+    queues[STAGE_CLASSIFY].push(frame);
+    return true;
+}
+
+/*
+ * Gets the result of the oldest frame that made it through all 
+ * the stages and wasn't collected yet.  Returns false if none is 
+ * waiting.
+ */
+bool stagedPipeline::collect(stagedResult& result) {
+    stagedFrame* frame = doneFrames.tryPop();
+    if (frame == 0) return false;
+    result = frame->result;
+    freeFrames.push(frame);
+    return true;
+}
+
+/*
+ * Runs one stage on a frame.
+ */
+void stagedPipeline::runStage(int stage, stagedFrame* frame) {
+    switch (stage) {
+        case STAGE_CLASSIFY:
+            classifier.update(frame->settings);
+            if (frame->settings.mode == LIGHT) classifier.classifyLight(frame->color, gray, frame->mask);
+            else {classifier.classifyColor(frame->color, hsv, frame->mask);}
+            break;
+        case STAGE_MORPHOLOGY:
+            filter.dilate(frame->mask);
+            filter.blurThreshold(frame->mask, MASK_BLUR_RADIUS, MASK_THRESHOLD);
+            break;
+        case STAGE_COMPONENTS: {
+            stagedResult& result = frame->result;
+            result.found = finder.find(frame->mask, minArea, maxArea, MAX_BLOBS) > 0;
+            result.x = result.y = result.area = result.confidence = 0;
+            if (result.found) {
+                result.x = finder.blobs[0].x;
+                result.y = finder.blobs[0].y;
+                result.area = finder.blobs[0].area;
+                float total = 0;
+                for (int i = 0; i < finder.blobs.size(); i++) {
+                    total += finder.blobs[i].area;
+                }
+                result.confidence = result.area / total;
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Waits for the frames still in flight and puts them back in 
+ * the pool, so the stages are idle.
+ */
+void stagedPipeline::drain() {
+    stagedFrame* idle[STAGED_FRAMES];
+    for (int i = 0; i < STAGED_FRAMES; i++) {
+        idle[i] = freeFrames.tryPop();
+        if (idle[i] == 0) idle[i] = doneFrames.pop();
+    }
+    for (int i = 0; i < STAGED_FRAMES; i++) {
+        freeFrames.push(idle[i]);
+    }
+}
+
+/*
+ * Runs every stage on a frame, one after another.
+ */
+void stagedPipeline::runSerial(stagedFrame* frame) {
+    for (int i = 0; i < NUM_STAGES; i++) {
+        runStage(i, frame);
+    }
+}
+
+/*
+ * Measures the tradeoff between running the stages one after 
+ * another and running them staged, on the given frame.  Serially, 
+ * a frame's latency is just the time to process it.  Staged, 
+ * frames are fed in as fast as the pool allows, which gives the 
+ * best throughput, and each frame's latency includes the time it 
+ * waited between stages.  Must not be called while frames are 
+ * being submitted.
+ */
+void stagedPipeline::benchmark(const imageBuffer& frame, const trackerSettings& settings, stagedBenchmark* results) {
+    drain();
+
+    stagedFrame* serial = freeFrames.pop();
+    unsigned long long begin = ofGetElapsedTimeMicros();
+    for (int i = 0; i < STAGED_BENCHMARK_FRAMES; i++) {
+        serial->color.copyFrom(frame.getPixels(), frame.width, frame.height, frame.stride, false);
+        serial->settings = settings;
+        runSerial(serial);
+    }
+    double elapsed = ofGetElapsedTimeMicros() - begin;
+    freeFrames.push(serial);
+    results->serialLatency = elapsed / STAGED_BENCHMARK_FRAMES / 1000;
+    results->serialFps = STAGED_BENCHMARK_FRAMES * 1000000 / elapsed;
+
+    start();
+    int submitted = 0, collected = 0;
+    double latency = 0;
+    begin = ofGetElapsedTimeMicros();
+    while (collected < STAGED_BENCHMARK_FRAMES) {
+        if (submitted < STAGED_BENCHMARK_FRAMES &&
+            submit(frame.getPixels(), frame.width, frame.height, frame.stride, false, settings, ofGetElapsedTimeMicros())) {
+            submitted++;
+            continue;
+        }
+        stagedFrame* done = doneFrames.pop();
+        latency += ofGetElapsedTimeMicros() - done->result.grabbed;
+        freeFrames.push(done);
+        collected++;
+    }
+    elapsed = ofGetElapsedTimeMicros() - begin;
+    results->stagedLatency = latency / STAGED_BENCHMARK_FRAMES / 1000;
+    results->stagedFps = STAGED_BENCHMARK_FRAMES * 1000000 / elapsed;
+}
+
+/*
+ * Sets which stage the worker runs.
+ */
+void stagedPipeline::stageWorker::setup(stagedPipeline* _owner, int _stage) {
+    owner = _owner;
+    stage = _stage;
+}
+
+/*
+ * Takes frames from the stage's queue, runs the stage on them 
+ * and passes them on to the next stage, or to the finished 
+ * frames after the last one.
+ */
+void stagedPipeline::stageWorker::threadedFunction() {
+    frameQueue& in = owner->queues[stage];
+    frameQueue& out = stage + 1 < NUM_STAGES ? owner->queues[stage + 1] : owner->doneFrames;
+    while (isThreadRunning()) {
+        stagedFrame* frame = in.pop();
+        if (frame == 0) break;
+        owner->runStage(stage, frame);
+        out.push(frame);
+    }
+}
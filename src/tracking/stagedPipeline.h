@@ -0,0 +1,135 @@
+/*
+ * stagedPipeline.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  Runs the stages of the tracker core on threads 
+ * of their own, so consecutive frames overlap: while one frame 
+ * is being cleaned up, the next one is already being classified. 
+ * Frames are grabbed on the caller's thread and go through the 
+ * classify, morphology and components stages.  Throughput is 
+ * limited by the slowest stage instead of all of them together, 
+ * at the cost of results arriving a few frames later.  There is 
+ * a fixed pool of frames; when all of them are in flight, new 
+ * frames are dropped.  CamShift depends on the previous frame's 
+ * result, so it can't be staged.
+ *
+ */
+
+#ifndef _STAGED_PIPELINE_H
+#define _STAGED_PIPELINE_H
+
+#include "ofMain.h"
+#include "trackerCore.h"
+#include "Poco/Semaphore.h"
+#include <deque>
+
+#define STAGED_FRAMES 6
+#define STAGED_BENCHMARK_FRAMES 200
+
+enum{STAGE_CLASSIFY, STAGE_MORPHOLOGY, STAGE_COMPONENTS, NUM_STAGES};
+
+/*
+ * What the stages found in a frame, and when it was grabbed, 
+ * in microseconds.
+ */
+struct stagedResult {
+    unsigned long long grabbed;
+    bool found;
+    float x, y, area, confidence;
+};
+
+/*
+ * A frame on its way through the stages, with its own buffers.
+ */
+struct stagedFrame {
+    imageBuffer color, mask;
+    trackerSettings settings;
+    stagedResult result;
+};
+
+/*
+ * What was measured by stagedPipeline::benchmark.  Latencies 
+ * are in milliseconds from grabbing a frame to its result.
+ */
+struct stagedBenchmark {
+    double serialFps, serialLatency;
+    double stagedFps, stagedLatency;
+};
+
+/*
+ * A queue of frames between two stages.  It never holds more 
+ * than the pool of frames, so pushing never blocks.
+ */
+class frameQueue {
+
+    public:
+
+        frameQueue();
+
+        void push(stagedFrame* frame);
+        stagedFrame* pop();
+        stagedFrame* tryPop();
+
+    private:
+
+        std::deque<stagedFrame*> frames;
+        ofMutex mutex;
+        Poco::Semaphore available;
+};
+
+class stagedPipeline {
+
+    public:
+
+        stagedPipeline();
+        virtual ~stagedPipeline();
+
+        void setup(int _width, int _height);
+        void start();
+        void stop();
+
+        bool submit(const unsigned char* pixels, int srcWidth, int srcHeight, int srcStride, bool mirror,
+                    const trackerSettings& settings, unsigned long long grabbed);
+        bool collect(stagedResult& result);
+        void benchmark(const imageBuffer& frame, const trackerSettings& settings, stagedBenchmark* results);
+
+    private:
+
+        /*
+         * Runs one stage on every frame that comes out of its 
+         * input queue.
+         */
+        class stageWorker : public ofThread {
+
+            public:
+
+                void setup(stagedPipeline* _owner, int _stage);
+                void threadedFunction();
+
+                stagedPipeline* owner;
+                int stage;
+        };
+
+        void runStage(int stage, stagedFrame* frame);
+        void runSerial(stagedFrame* frame);
+        void drain();
+
+        int width, height;
+        stagedFrame frames[STAGED_FRAMES];
+        frameQueue freeFrames, doneFrames;
+        frameQueue queues[NUM_STAGES];
+        stageWorker workers[NUM_STAGES];
+        bool running;
+
+        //each stage's own tools, only used by its thread
+        pixelClassifier classifier;
+        imageBuffer gray, hsv;
+        maskFilter filter;
+        blobFinder finder;
+        int minArea, maxArea;
+};
+
+#endif
@@ -8,7 +8,12 @@
  * Description:  The tracker.  Analyzes the video 
  * feed and determines the location of the area that 
  * has been configured to be tracked.  Can either 
- * track a light source or any selected color.
+ * track a light source, any selected color, or a color 
+ * histogram that follows the target with CamShift.  
+ * Several sources can be combined, each covering part 
+ * of the screen and processed on its own thread.  The 
+ * analysis itself is done by the tracker core; this 
+ * class connects it to openFrameworks.
  *
  */
 
@@ -21,23 +26,65 @@ tracker::tracker() {
     width = 360;
     height = 240;
 
-    minArea = 2;
-    maxArea = (int)(width * height * .33);
+    x = y = 0;
+    demand = TRACK_POSITION;
+    lastFrame = -1;
+    staged = false;
 
-    threshold = 80;
+    latching = true;
+    extrapolating = false;
+    maxLead = LATCH_MAX_LEAD;
+    latchSaving = latchLead = 0;
+    sampleTime = lastSampleTime = updateSampleTime = 0;
 
-    lastX = lastY = 0;
+    numTargets = 1;
+    for (int i = 0; i < MAX_TARGETS; i++) {
+        targetSeen[i] = false;
+    }
 }
 
 /*
  * Deleting the tracker.
  */
 tracker::~tracker() {
+    for (int i = 0; i < channels.size(); i++) {
+        delete channels[i];
+    }
+    for (int i = 0; i < pendingSources.size(); i++) {
+        delete pendingSources[i];
+    }
+}
+
+/*
+ * Adds a frame source covering the given area of the screen.  The 
+ * area is normalized, i.e. (0, 0, 1, 1) is the whole screen.  Must 
+ * be called before setup.  The tracker takes ownership of the source.
+ */
+void tracker::addSource(frameSource* source, ofRectangle area) {
+    pendingSources.push_back(source);
+    pendingAreas.push_back(area);
+}
+
+/*
+ * Sets whether each source's stages run on threads of their own, 
+ * overlapping consecutive frames.  That gets more frames through 
+ * when processing is slower than the camera, but every position 
+ * arrives a few frames late.  Only used while just the position 
+ * of one target is needed, and not with CamShift.
+ */
+void tracker::setStaged(bool _staged) {
+    staged = _staged;
+    for (int i = 0; i < channels.size(); i++) {
+        channels[i]->setStaged(staged && numTargets == 1);
+    }
 }
 
 /*
  * Sets up the tracker.  Sets the camera width/height, and the 
- * total screen width/height
+ * total screen width/height.  If no sources were added, the 
+ * default camera is used for the whole screen.  Sources that 
+ * can't be opened are dropped.  With more than one source, 
+ * every source gets its own worker thread.
  */
 void tracker::setup(int _width, int _height, int _screenWidth, int _screenHeight) {
     width = _width;
@@ -45,100 +92,182 @@ void tracker::setup(int _width, int _height, int _screenWidth, int _screenHeight
     screenWidth = _screenWidth;
     screenHeight = _screenHeight;
 
-    maxArea = (int)(width * height * .33);
-
-    vidGrabber.setVerbose(true);
-    vidGrabber.initGrabber(width, height);
-
-    capturedImageData.allocate(width, height);
-    HSVImageData.allocate(width, height);
-    grayImageData.allocate(width, height);
-    thresholdImageData.allocate(width, height);
-    grayHueData.allocate(width, height);
-    graySaturationData.allocate(width, height);
-    grayValueData.allocate(width, height);
-
-    grayPixels = new unsigned char [width * height];
+    if (pendingSources.empty()) addSource(new cameraSource(), ofRectangle(0, 0, 1, 1));
+    for (int i = 0; i < pendingSources.size(); i++) {
+        trackerChannel* channel = new trackerChannel(pendingSources[i], pendingAreas[i]);
+        channel->setStaged(staged && numTargets == 1);
+        if (channel->setup(this, width, height)) channels.push_back(channel);
+        else {delete channel;}
+    }
+    pendingSources.clear();
+    pendingAreas.clear();
+    if (channels.size() > 1) {
+        for (int i = 0; i < channels.size(); i++) {
+            channels[i]->start();
+        }
+    }
+}
 
-    mode = LIGHT;
+/*
+ * Updates the tracker.  Nothing is done if nobody needs tracking, 
+ * or if the tracker was already updated this frame.
+ */
+void tracker::update() {
+    if (demand == TRACK_NONE || lastFrame == ofGetFrameNum()) return;
+    lastFrame = ofGetFrameNum();
+    measure();
+    updateSampleTime = sampleTime;
+}
 
-    hueRange = 20;
-    saturationRange = 30;
-    valueRange = 25;
-    
-    hue = 0;
-    saturation = 0;
-    value = 0;
+/*
+ * Gets the position to draw with, as late as possible, right before 
+ * drawing.  If a source got a new frame since the update it is 
+ * processed now, so the frame is shown this time instead of next. 
+ * With extrapolation on, the position is also moved along its 
+ * current velocity to when the frame should reach the screen, at 
+ * most maxLead seconds ahead.  How much newer the latched sample is 
+ * than the one the update had, and how far ahead of it the drawn 
+ * position was extrapolated, are kept apart as running averages.
+ */
+void tracker::latch() {
+    if (demand == TRACK_NONE) return;
+    if (latching) measure();
+
+    double lead = 0;
+    if (extrapolating && sampleTime > lastSampleTime && lastSampleTime > 0) {
+        double now = ofGetElapsedTimeMicros() / 1000000.0;
+        double period = ofGetFrameRate() > 0 ? 1.0 / ofGetFrameRate() : 1.0 / 60;
+        lead = min(max(now + period - sampleTime, 0.0), maxLead);
+    }
+    for (int i = 0; i < numTargets; i++) {
+        drawTargets[i] = targets[i];
+        if (lead > 0) drawTargets[i] += (targets[i] - lastTargets[i]) * (lead / (sampleTime - lastSampleTime));
+    }
+    if (updateSampleTime > 0) latchSaving = latchSaving * 0.95 + (sampleTime - updateSampleTime) * 1000 * 0.05;
+    latchLead = latchLead * 0.95 + lead * 1000 * 0.05;
 }
 
 /*
- * Updates the tracker.  Depending on the mode, it searches through the 
- * video data looking for pixels that match the settings provided.  If 
- * a pixel matches, it is set to white, if not, it is set to black.  That 
- * new image goes to the contour finder, which finds holes.  The first 
- * contour is used as the area that is being tracked.
+ * Processes every source with a new frame, in parallel when there 
+ * is more than one.  Once all of them are done, the results are 
+ * merged: the largest target found on a source with a new frame 
+ * becomes the tracked position.  Sources without a new frame still 
+ * hold what they found in an older one, so they are left out. 
+ * With more than one target, the largest ones found are matched 
+ * to the targets instead.  Returns if there was a new frame.
  */
-void tracker::update() {
-    lastX = getX();
-    lastY = getY();
-    vidGrabber.grabFrame();
+bool tracker::measure() {
+    vector<trackerChannel*> updated;
+    for (int i = 0; i < channels.size(); i++) {
+        channels[i]->setDebug(demand == TRACK_DEBUG);
+        if (channels[i]->grab()) updated.push_back(channels[i]);
+    }
+    if (updated.empty()) return false;
 
-    if (vidGrabber.isFrameNew()) {
-        capturedImageData.setFromPixels(vidGrabber.getPixels(), width, height);
-        capturedImageData.mirror(false, true);
-        grayImageData.setFromColorImage(capturedImageData);
+    if (channels.size() == 1) updated[0]->process();
+    else {
+        for (int i = 0; i < updated.size(); i++) {
+            updated[i]->submit();
+        }
+        for (int i = 0; i < updated.size(); i++) {
+            updated[i]->waitUntilProcessed();
+        }
+    }
 
-        //grayImageData.contrastStretch();
+    trackerChannel* best = 0;
+    for (int i = 0; i < updated.size(); i++) {
+        if (updated[i]->hasTarget() && (best == 0 || updated[i]->getArea() > best->getArea())) {
+            best = updated[i];
+        }
+    }
+    for (int i = 0; i < numTargets; i++) {
+        lastTargets[i] = targets[i];
+    }
+    lastSampleTime = sampleTime;
+    sampleTime = ofGetElapsedTimeMicros() / 1000000.0;
+    if (numTargets > 1) matchTargets(updated);
+    else if (best != 0) {
+        targets[0] = best->getScreenPosition(screenWidth, screenHeight);
+        targetSeen[0] = true;
+    }
+    x = targets[0].x;
+    y = targets[0].y;
+
+    if (ring.isOpen()) {
+        trackerSample sample;
+        sample.found = best != 0;
+        sample.x = x;
+        sample.y = y;
+        sample.area = best != 0 ? best->getArea() : 0;
+        sample.confidence = best != 0 ? best->getConfidence() : 0;
+        ring.publish(sample);
+    }
+    return true;
+}
 
-        if (mode == LIGHT) {        
-            thresholdImageData = grayImageData;
-            thresholdImageData.threshold(threshold);
+/*
+ * Gathers the largest things found on the given sources, the ones 
+ * with a new frame, and matches them to the targets.  Over and over, the closest pair of a target 
+ * and a found thing is matched, so each target keeps following what 
+ * it followed before.  Targets that haven't been seen yet take what 
+ * is left, largest first.  Targets with nothing to match stay where 
+ * they were.
+ */
+void tracker::matchTargets(const vector<trackerChannel*>& updated) {
+    found.clear();
+    for (int i = 0; i < updated.size(); i++) {
+        updated[i]->getTargets(screenWidth, screenHeight, found);
+    }
+    for (int i = 1; i < found.size(); i++) {
+        for (int j = i; j > 0 && found[j].area > found[j - 1].area; j--) {
+            swap(found[j], found[j - 1]);
         }
-        else {
-            HSVImageData = capturedImageData;
-            HSVImageData.convertRgbToHsv();
-
-            unsigned char * colorPixels = HSVImageData.getPixels();
-
-            for (int i = 0; i < width*height; i++){
-            
-                // since hue is cyclical:
-                int hueDiff = colorPixels[i*3] - hue;
-                if (hueDiff < -127) hueDiff += 255;
-                if (hueDiff > 127) hueDiff -= 255;
-            
-            
-                if ((abs(hueDiff) < hueRange) &&
-                    (colorPixels[i*3+1] > (saturation - saturationRange) && colorPixels[i*3+1] < (saturation + saturationRange)) &&
-                    (colorPixels[i*3+2] > (value - valueRange) && colorPixels[i*3+2] < (value + valueRange))){
-    
-                    grayPixels[i] = 255;
-        
-                } else {
-                    
-                    grayPixels[i] = 0;
+    }
+    if (found.size() > numTargets) found.resize(numTargets);
+
+    bool matched[MAX_TARGETS];
+    for (int i = 0; i < numTargets; i++) {
+        matched[i] = false;
+    }
+    while (!found.empty()) {
+        int bestTarget = -1, bestFound = 0;
+        float bestDist = 0;
+        for (int i = 0; i < numTargets; i++) {
+            if (matched[i] || !targetSeen[i]) continue;
+            for (int j = 0; j < found.size(); j++) {
+                ofPoint d = found[j].position - targets[i];
+                float dist = d.x * d.x + d.y * d.y;
+                if (bestTarget < 0 || dist < bestDist) {
+                    bestTarget = i;
+                    bestFound = j;
+                    bestDist = dist;
                 }
-                
             }
-            thresholdImageData.setFromPixels(grayPixels, width, height);
         }
-
-        thresholdImageData.dilate();
-        thresholdImageData.blurHeavily();
-        thresholdImageData.threshold(10);
-
-        contourFinder.findContours(thresholdImageData, minArea, maxArea, 10, false, false);
+        if (bestTarget < 0) {
+            for (int i = 0; i < numTargets && bestTarget < 0; i++) {
+                if (!matched[i]) bestTarget = i;
+            }
+        }
+        targets[bestTarget] = found[bestFound].position;
+        targetSeen[bestTarget] = true;
+        matched[bestTarget] = true;
+        found.erase(found.begin() + bestFound);
     }
 }
 
 /*
- * Draws a circle at the current position being tracked.
+ * Draws a circle at every position being tracked, if anything is 
+ * being tracked.  Uses the positions from the last latch.
  */
 void tracker::draw() {
+    if (demand == TRACK_NONE) return;
     ofPushStyle();
     ofNoFill();
     ofSetColor(255, 255, 255);
-    ofCircle(getX(), getY(), 4);
+    for (int i = 0; i < numTargets; i++) {
+        ofCircle(drawTargets[i].x, drawTargets[i].y, 4);
+    }
     ofPopStyle();
 }
 
@@ -151,162 +280,289 @@ void tracker::resized(int w, int h) {
 }
 
 /*
- * Returns the x position of the object being tracked.
+ * Publishes every sample of the tracker to other processes, in 
+ * a shared memory ring with the given name and number of slots. 
+ * Returns false if the ring couldn't be made.
  */
-float tracker::getX() {
-    if( contourFinder.nBlobs > 0 ) return (contourFinder.blobs[0].centroid.x / width) * screenWidth;
-    return lastX;
+bool tracker::publish(string name, int capacity) {
+    return ring.create(name, capacity);
 }
 
 /*
- * Returns the y position of the object being tracked.
+ * Sets how many seconds each source's flight recorder keeps, 
+ * and how many bytes it may use at most.
  */
-float tracker::getY() {
-    if( contourFinder.nBlobs > 0 ) return (contourFinder.blobs[0].centroid.y / height) * screenHeight;
-    return lastY;
+void tracker::setRecording(double seconds, int budget) {
+    for (int i = 0; i < channels.size(); i++) {
+        channels[i]->getRecorder()->setup(seconds, budget);
+    }
+}
+
+/*
+ * Writes what the flight recorders hold to a new directory in 
+ * recordings, with a directory for each source.  Returns false 
+ * if something couldn't be written.
+ */
+bool tracker::dumpRecording() {
+    string directory = "recordings/flight-" + ofToString(ofGetUnixTime());
+    bool dumped = true;
+    for (int i = 0; i < channels.size(); i++) {
+        string path = ofToDataPath(directory + "/source" + ofToString(i), true);
+        dumped = ofDirectory::createDirectory(path, false, true) && channels[i]->getRecorder()->dump(path) && dumped;
+    }
+    return dumped;
+}
+
+/*
+ * Sets whether sources are processed again right before drawing, 
+ * whether the drawn position is extrapolated, and by how many 
+ * seconds at most.
+ */
+void tracker::setLatching(bool _latching, bool _extrapolating, double _maxLead) {
+    latching = _latching;
+    extrapolating = _extrapolating;
+    maxLead = _maxLead;
+}
+
+/*
+ * Returns how many milliseconds newer, on average, the latched 
+ * sample is than the one the update had.  This is measured, and 
+ * doesn't include extrapolation.
+ */
+double tracker::getLatchSaving() {
+    return latchSaving;
+}
+
+/*
+ * Returns how many milliseconds ahead of the latched sample, on 
+ * average, the drawn position was extrapolated.  This is predicted, 
+ * not measured.
+ */
+double tracker::getLatchLead() {
+    return latchLead;
+}
+
+/*
+ * Sets how much tracking is needed.  With TRACK_NONE the sources 
+ * are not even polled, TRACK_POSITION only finds the target, and 
+ * TRACK_DEBUG also keeps what is needed to show the tracker's 
+ * intermediate images.
+ */
+void tracker::setDemand(int _demand) {
+    demand = _demand;
 }
 
 /*
- * Returns a pointer to the initial video data.
+ * Returns how much tracking is needed.
  */
-ofxCvColorImage* tracker::getColorData() {
-    return &capturedImageData;
+int tracker::getDemand() {
+    return demand;
 }
 
 /*
- * Returns a pointer to a grascaled version of the video data.
+ * Sets how many targets to follow, from 1 to MAX_TARGETS.  The 
+ * stages only find one, so they aren't used for more.
  */
-ofxCvGrayscaleImage* tracker::getGrayscaleData() {
-    return &grayImageData;
+void tracker::setNumTargets(int _numTargets) {
+    numTargets = max(1, min(MAX_TARGETS, _numTargets));
+    for (int i = 1; i < MAX_TARGETS; i++) {
+        targetSeen[i] = false;
+    }
+    setStaged(staged);
 }
 
 /*
- * Returns a pointer to the black/white data that represents 
- * pixels that matched the settings.
+ * Returns how many targets are followed.
  */
-ofxCvGrayscaleImage* tracker::getThresholdData() {
-    return &thresholdImageData;
+int tracker::getNumTargets() {
+    return numTargets;
 }
 
 /*
- * Returns a pointer to the contour finder.
+ * Returns the width of the frames the tracker analyzes.
  */
-ofxCvContourFinder* tracker::getContours() {
-    return &contourFinder;
+int tracker::getCameraWidth() {
+    return width;
 }
 
 /*
- * Returns a pointer to the threshold value.
+ * Returns the height of the frames the tracker analyzes.
  */
-int* tracker::getThreshold() {
-    return &threshold;
+int tracker::getCameraHeight() {
+    return height;
 }
 
 /*
- * Sets the threshold.
+ * Returns the x position of the object being tracked.
  */
-void tracker::setThreshold(int _value) {
-    threshold = _value;
+float tracker::getX() {
+    return x;
 }
 
 /*
- * Returns a pointer to the hue range.
+ * Returns the y position of the object being tracked.
  */
-int* tracker::getHueRange() {
-    return &hueRange;
+float tracker::getY() {
+    return y;
 }
 
 /*
- * Returns a pointer to the saturation range.
+ * Returns the x position to draw the object being tracked at.
  */
-int* tracker::getSaturationRange() {
-    return &saturationRange;
+float tracker::getDrawX() {
+    return drawTargets[0].x;
 }
 
 /*
- * Returns a pointer to the value range.
+ * Returns the y position to draw the object being tracked at.
  */
-int* tracker::getValueRange() {
-    return &valueRange;
+float tracker::getDrawY() {
+    return drawTargets[0].y;
 }
 
 /*
- * Returns a pointer to the target hue.
+ * Returns the position of the given target.  The first target is 
+ * the one getX and getY return.
  */
-int* tracker::getHue() {
-    return &hue;
+ofPoint tracker::getTarget(int index) {
+    return targets[index];
 }
 
 /*
- * Returns a pointer to the target saturation.
+ * Returns the position to draw the given target at.
  */
-int* tracker::getSaturation() {
-    return &saturation;
+ofPoint tracker::getDrawTarget(int index) {
+    return drawTargets[index];
 }
 
 /*
- * Returns a pointer to the target value.
+ * Returns when the targets were last measured, in seconds since 
+ * the app started, or 0 if they haven't been yet.
  */
-int* tracker::getValue() {
-    return &value;
+double tracker::getSampleTime() {
+    return sampleTime;
 }
 
 /*
- * Sets the hue range.
+ * Returns a texture of the initial video data of the first source. 
+ * This and the other first source accessors return nothing if no 
+ * source could be opened.
  */
-void tracker::setHueRange(int _value) {
-    hueRange = _value;
+ofTexture* tracker::getColorData() {
+    if (channels.empty()) return 0;
+    return channels[0]->getColorData();
 }
 
 /*
- * Sets the saturation range.
+ * Returns a texture of a grascaled version of the video data 
+ * of the first source.
  */
-void tracker::setSaturationRange(int _value) {
-    saturationRange = _value;
+ofTexture* tracker::getGrayscaleData() {
+    if (channels.empty()) return 0;
+    return channels[0]->getGrayscaleData();
 }
 
 /*
- * Sets the value range.
+ * Returns a texture of the black/white data that represents 
+ * pixels of the first source that matched the settings.
  */
-void tracker::setValueRange(int _value) {
-    valueRange = _value;
+ofTexture* tracker::getThresholdData() {
+    if (channels.empty()) return 0;
+    return channels[0]->getThresholdData();
 }
 
 /*
- * Sets the target hue.
+ * Returns the blobs found in the first source, largest first.
  */
-void tracker::setHue(int _value) {
-    hue = _value;
+const vector<blob>& tracker::getBlobs() {
+    if (channels.empty()) return noBlobs;
+    return channels[0]->getCore()->getBlobs();
 }
 
 /*
- * Sets the target saturation.
+ * Returns a snapshot of the current settings.  The snapshot is 
+ * always a complete set, never one that is halfway through 
+ * being changed.
  */
-void tracker::setSaturation(int _value) {
-    saturation = _value;
+trackerSettings tracker::getSettings() {
+    settingsMutex.lock();
+    trackerSettings snapshot = settings;
+    settingsMutex.unlock();
+    return snapshot;
 }
 
 /*
- * Sets the target value.
+ * Publishes new settings.  If anything changed, the version moves 
+ * on so that the channels rebuild what they derive from them.
  */
-void tracker::setValue(int _value) {
-    value = _value;
+void tracker::setSettings(trackerSettings _settings) {
+    settingsMutex.lock();
+    if (!_settings.sameAs(settings)) {
+        _settings.version = settings.version + 1;
+        settings = _settings;
+    }
+    settingsMutex.unlock();
 }
 
 /*
  * Sets the target hue, saturation, and value to that of the pixel
- * at the given position.
+ * at the given position of the first source.
  */
 void tracker::setHueSatValByPixel(int pixel) {
-    if (pixel >=0 && pixel <= width * height) {
-        HSVImageData.convertToGrayscalePlanarImages(grayHueData, graySaturationData, grayValueData);
-        
-        grayHueData.flagImageChanged();
-        graySaturationData.flagImageChanged();
-        grayValueData.flagImageChanged();
-
-        hue = grayHueData.getPixels()[pixel];
-        saturation = graySaturationData.getPixels()[pixel];
-        value = grayValueData.getPixels()[pixel];
+    unsigned char hsv[3];
+    if (channels.empty()) return;
+    if (pixel >= 0 && pixel < width * height && channels[0]->getCore()->getHsvAt(pixel % width, pixel / width, hsv)) {
+        trackerSettings changed = getSettings();
+        changed.hue = hsv[0];
+        changed.saturation = hsv[1];
+        changed.value = hsv[2];
+        setSettings(changed);
+    }
+}
+
+/*
+ * Builds the CamShift target histogram from the area around the 
+ * given position of the first source.  The first source starts 
+ * searching there, all others search their whole frame.
+ */
+void tracker::setHistogramByPixel(int pixel) {
+    if (channels.empty() || pixel < 0 || pixel >= width * height) return;
+
+    trackerSettings changed = getSettings();
+    for (int i = 1; i < channels.size(); i++) {
+        channels[i]->getCore()->resetSearchWindow();
+    }
+    if (channels[0]->getCore()->buildHistogram(pixel % width, pixel / width, changed.histogram)) {
+        changed.hasHistogram = true;
+        setSettings(changed);
     }
 }
+
+/*
+ * Returns whether or not a CamShift target has been picked.
+ */
+bool tracker::hasTarget() {
+    return getSettings().hasHistogram;
+}
+
+/*
+ * Returns the CamShift search window of the first source in 
+ * camera coordinates.
+ */
+ofRectangle tracker::getSearchWindow() {
+    if (channels.empty()) return ofRectangle();
+    camShift& shift = channels[0]->getCore()->getCamShift();
+    return ofRectangle(shift.winX, shift.winY, shift.winW, shift.winH);
+}
+
+/*
+ * Times the specialized pipelines against the generic ones, and 
+ * running the stages one after another against running them 
+ * staged, on the last frame of the first source.  The frame is 
+ * only kept while debugging.
+ */
+void tracker::benchmark(pipelineBenchmark* results, stagedBenchmark* stagedResults) {
+    if (channels.empty() || !channels[0]->getCore()->getColor().isAllocated()) return;
+    results->run(channels[0]->getCore()->getColor(), getSettings(), BENCHMARK_FRAMES);
+    channels[0]->benchmarkStages(stagedResults);
+}
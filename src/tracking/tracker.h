@@ -8,16 +8,31 @@
  * Description:  The tracker.  Analyzes the video 
  * feed and determines the location of the area that 
  * has been configured to be tracked.  Can either 
- * track a light source or any selected color.
+ * track a light source, any selected color, or a color 
+ * histogram that follows the target with CamShift.  
+ * Several sources can be combined, each covering part 
+ * of the screen and processed on its own thread.  Up to 
+ * MAX_TARGETS targets can be followed at once, one for 
+ * each player.  The analysis itself is done by the 
+ * tracker core; this class connects it to openFrameworks.
  *
  */
 
 #ifndef _TRACKER_H
 #define _TRACKER_H
 
-#include "ofxOpenCv.h"
+#include "ofMain.h"
+#include "frameSource.h"
+#include "trackerSettings.h"
+#include "trackerChannel.h"
+#include "pipelineBenchmark.h"
+#include "sampleRing.h"
 
-enum{LIGHT, MANUAL};
+#define LATCH_MAX_LEAD 0.05
+#define MAX_TARGETS 4
+
+//how much tracking is needed, from nothing to everything
+enum{TRACK_NONE, TRACK_POSITION, TRACK_DEBUG};
 
 class tracker {
 
@@ -26,57 +41,76 @@ class tracker {
         tracker();
         virtual ~tracker();
 
+        void addSource(frameSource* source, ofRectangle area);
+        void setStaged(bool _staged);
         void setup(int _width, int _height, int _screenWidth, int _screenHeight);
         void update();
+        void latch();
         void draw();
         void resized(int w, int h);
 
-        ofxCvColorImage* getColorData();
-        ofxCvGrayscaleImage* getGrayscaleData();
-        ofxCvGrayscaleImage* getThresholdData();
-        ofxCvContourFinder*  getContours();
-        int* getThreshold();
+        bool publish(string name, int capacity);
+        void setRecording(double seconds, int budget);
+        bool dumpRecording();
+        void setLatching(bool _latching, bool _extrapolating, double _maxLead);
+        double getLatchSaving();
+        double getLatchLead();
+
+        void setDemand(int _demand);
+        int getDemand();
+        void setNumTargets(int _numTargets);
+        int getNumTargets();
+
+        ofTexture* getColorData();
+        ofTexture* getGrayscaleData();
+        ofTexture* getThresholdData();
+        const vector<blob>& getBlobs();
         float getX();
         float getY();
-        int* getHueRange();
-        int* getSaturationRange();
-        int* getValueRange();
-        int* getHue();
-        int* getSaturation();
-        int* getValue();
-        void setThreshold(int _value);
-        void setHueRange(int _value);
-        void setSaturationRange(int _value);
-        void setValueRange(int _value);
-        void setHue(int _value);
-        void setSaturation(int _value);
-        void setValue(int _value);
+        float getDrawX();
+        float getDrawY();
+        ofPoint getTarget(int index);
+        ofPoint getDrawTarget(int index);
+        double getSampleTime();
+        int getCameraWidth();
+        int getCameraHeight();
 
+        trackerSettings getSettings();
+        void setSettings(trackerSettings _settings);
 
         void setHueSatValByPixel(int pixel);
-
-        int mode;
+        void setHistogramByPixel(int pixel);
+        bool hasTarget();
+        ofRectangle getSearchWindow();
+        void benchmark(pipelineBenchmark* results, stagedBenchmark* stagedResults);
 
     private:
-    
-        ofVideoGrabber         vidGrabber;
-        ofxCvContourFinder  contourFinder;
-
-        ofxCvColorImage     capturedImageData;
-        ofxCvColorImage     HSVImageData;
-        ofxCvGrayscaleImage grayImageData;
-        ofxCvGrayscaleImage thresholdImageData;
-        ofxCvGrayscaleImage    grayHueData;
-        ofxCvGrayscaleImage    graySaturationData;
-        ofxCvGrayscaleImage    grayValueData;
-
-        unsigned char *            grayPixels;
-        
-        int width, height, screenWidth, screenHeight, minArea, maxArea;
-        int threshold;
-        float lastX, lastY;
-        int hue, saturation, value;
-        int hueRange, saturationRange, valueRange;
+
+        bool measure();
+        void matchTargets(const vector<trackerChannel*>& updated);
+
+        vector<trackerChannel*> channels;
+        vector<frameSource*> pendingSources;
+        vector<ofRectangle> pendingAreas;
+
+        int width, height, screenWidth, screenHeight;
+        float x, y;
+        int demand, lastFrame;
+
+        bool latching, extrapolating;
+        double maxLead, latchSaving, latchLead;
+        double sampleTime, lastSampleTime, updateSampleTime;
+        bool staged;
+
+        int numTargets;
+        ofPoint targets[MAX_TARGETS], lastTargets[MAX_TARGETS], drawTargets[MAX_TARGETS];
+        bool targetSeen[MAX_TARGETS];
+        vector<trackerTarget> found;
+        vector<blob> noBlobs;
+
+        trackerSettings settings;
+        ofMutex settingsMutex;
+        sampleRingWriter ring;
 };
 
 #endif
@@ -0,0 +1,309 @@
+/*
+ * trackerChannel.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  One frame source and the tracker core that 
+ * analyzes it.  Each channel can be processed on its own 
+ * thread, and its stages can overlap consecutive frames. 
+ * The position it finds is mapped into the area of the 
+ * screen the source covers.
+ *
+ */
+
+#include "trackerChannel.h"
+#include "tracker.h"
+
+/*
+ * Constructor setting the source and the normalized area of 
+ * the screen that it covers.  The channel takes ownership of 
+ * the source.
+ */
+trackerChannel::trackerChannel(frameSource* _source, ofRectangle _area) : frameReady(0, 1), frameDone(0, 1) {
+    source = _source;
+    mapping = screenMapping(_area.x, _area.y, _area.width, _area.height);
+    owner = 0;
+    texturesAllocated = false;
+    debug = false;
+    staged = stagesReady = usingStages = false;
+    result.found = false;
+}
+
+/*
+ * Deleting the channel.  Stops the worker and closes the source.
+ */
+trackerChannel::~trackerChannel() {
+    stop();
+    source->close();
+    delete source;
+}
+
+/*
+ * Sets up the channel.  Opens the source and sets up the core at 
+ * the tracker's resolution.  Sources with a different resolution 
+ * are scaled to it.
+ */
+bool trackerChannel::setup(tracker* t, int _width, int _height) {
+    owner = t;
+    if (!source->setup(_width, _height)) return false;
+    core.setup(_width, _height);
+    return true;
+}
+
+/*
+ * Starts the worker thread.
+ */
+void trackerChannel::start() {
+    startThread(false, false);
+}
+
+/*
+ * Stops the worker thread and the stages.  Wakes the worker up 
+ * so it can see that it has been stopped.
+ */
+void trackerChannel::stop() {
+    if (isThreadRunning()) {
+        stopThread();
+        frameReady.set();
+        waitForThread(false);
+    }
+    stages.stop();
+}
+
+/*
+ * Sets whether the channel keeps what is needed to show its 
+ * images.  Once it stops, the textures are freed too.  Only 
+ * called while the worker is idle.
+ */
+void trackerChannel::setDebug(bool _debug) {
+    debug = _debug;
+    core.setDebug(debug);
+    if (!debug) releaseTextures();
+}
+
+/*
+ * Sets whether frames go through the stages on threads of their 
+ * own.  Only done when just the position is needed and the mode 
+ * doesn't depend on the previous frame, otherwise the core is 
+ * used as usual.
+ */
+void trackerChannel::setStaged(bool _staged) {
+    staged = _staged;
+}
+
+/*
+ * Polls the source.  Returns if there is a new frame to process.
+ */
+bool trackerChannel::grab() {
+    source->update();
+    return source->isFrameNew();
+}
+
+/*
+ * Hands the current frame to the worker thread.
+ */
+void trackerChannel::submit() {
+    frameReady.set();
+}
+
+/*
+ * Blocks until the worker has finished the submitted frame.
+ */
+void trackerChannel::waitUntilProcessed() {
+    frameDone.wait();
+}
+
+/*
+ * The worker.  Processes a frame every time one is submitted.
+ */
+void trackerChannel::threadedFunction() {
+    while (isThreadRunning()) {
+        frameReady.wait();
+        if (!isThreadRunning()) break;
+        process();
+        frameDone.set();
+    }
+}
+
+/*
+ * Processes the current frame of the source.  Takes a snapshot of 
+ * the tracker's settings first, so the whole frame is processed 
+ * with one consistent set.  The frame is mirrored so the screen 
+ * moves the same way as the player.  The frame and what was found 
+ * in it go to the flight recorder.  Staged results arrive a few 
+ * frames later, so a staged frame is recorded without a position 
+ * or mask, and its result is added once it comes out of the stages.
+ */
+void trackerChannel::process() {
+    settings = owner->getSettings();
+    unsigned char* pixels = source->getPixels();
+    int srcWidth = source->getWidth();
+    int srcHeight = source->getHeight();
+
+    usingStages = staged && !debug && settings.mode != CAMSHIFT;
+    if (usingStages) {
+        prepareStages();
+        stages.start();
+        unsigned long long grabbed = ofGetElapsedTimeMicros();
+        stages.submit(pixels, srcWidth, srcHeight, srcWidth * 3, true, settings, grabbed);
+        recorder.record(grabbed / 1000000.0, pixels, srcWidth, srcHeight, srcWidth * 3, true, 0, false, 0, 0, 0);
+        stagedResult done;
+        while (stages.collect(done)) {
+            recorder.setResult(done.grabbed / 1000000.0, done.found, done.x, done.y, done.area);
+            result = done;
+        }
+        return;
+    }
+    core.process(pixels, srcWidth, srcHeight, srcWidth * 3, true, settings);
+    recorder.record(ofGetElapsedTimeMicros() / 1000000.0, pixels, srcWidth, srcHeight, srcWidth * 3, true, &core.getMask(),
+                    core.hasTarget(), core.getX(), core.getY(), core.getArea());
+}
+
+/*
+ * Returns if the target was found in the last processed frame.
+ */
+bool trackerChannel::hasTarget() {
+    if (usingStages) return result.found;
+    return core.hasTarget();
+}
+
+/*
+ * Returns the area, in camera pixels, of the target found in 
+ * the last processed frame.
+ */
+float trackerChannel::getArea() {
+    if (usingStages) return result.area;
+    return core.getArea();
+}
+
+/*
+ * Returns how sure the core is of the target, from 0 to 1.
+ */
+float trackerChannel::getConfidence() {
+    if (usingStages) return result.confidence;
+    return core.getConfidence();
+}
+
+/*
+ * Returns the position of the target mapped into the area of 
+ * the screen that this channel covers.
+ */
+ofPoint trackerChannel::getScreenPosition(int screenWidth, int screenHeight) {
+    float x, y;
+    if (usingStages) mapping.map(result.x, result.y, core.width, core.height, screenWidth, screenHeight, x, y);
+    else {mapping.map(core.getX(), core.getY(), core.width, core.height, screenWidth, screenHeight, x, y);}
+    return ofPoint(x, y);
+}
+
+/*
+ * Adds everything found in the last processed frame to targets, 
+ * largest first.  That is every blob, or just the target when 
+ * following it with CamShift or running the stages.
+ */
+void trackerChannel::getTargets(int screenWidth, int screenHeight, vector<trackerTarget>& targets) {
+    if (!hasTarget()) return;
+    const vector<blob>& blobs = core.getBlobs();
+    if (usingStages || blobs.empty()) {
+        trackerTarget target;
+        target.position = getScreenPosition(screenWidth, screenHeight);
+        target.area = getArea();
+        targets.push_back(target);
+        return;
+    }
+    for (int i = 0; i < blobs.size(); i++) {
+        trackerTarget target;
+        mapping.map(blobs[i].x, blobs[i].y, core.width, core.height, screenWidth, screenHeight,
+                    target.position.x, target.position.y);
+        target.area = blobs[i].area;
+        targets.push_back(target);
+    }
+}
+
+/*
+ * Returns a pointer to the tracker core.
+ */
+trackerCore* trackerChannel::getCore() {
+    return &core;
+}
+
+/*
+ * Measures running the stages one after another against running 
+ * them staged, on the last frame the core kept.
+ */
+void trackerChannel::benchmarkStages(stagedBenchmark* results) {
+    if (!core.getColor().isAllocated()) return;
+    prepareStages();
+    stages.benchmark(core.getColor(), settings, results);
+}
+
+/*
+ * Returns the flight recorder of the channel.  Only to be used 
+ * while the channel is idle.
+ */
+flightRecorder* trackerChannel::getRecorder() {
+    return &recorder;
+}
+
+/*
+ * Allocates the stages' frames the first time they are needed.
+ */
+void trackerChannel::prepareStages() {
+    if (stagesReady) return;
+    stages.setup(core.width, core.height);
+    stagesReady = true;
+}
+
+/*
+ * Allocates the textures the debug images are uploaded to.
+ */
+void trackerChannel::allocateTextures() {
+    if (texturesAllocated) return;
+    colorTexture.allocate(core.width, core.height, GL_RGB);
+    grayTexture.allocate(core.width, core.height, GL_LUMINANCE);
+    thresholdTexture.allocate(core.width, core.height, GL_LUMINANCE);
+    texturesAllocated = true;
+}
+
+/*
+ * Frees the textures of the images.
+ */
+void trackerChannel::releaseTextures() {
+    if (!texturesAllocated) return;
+    colorTexture.clear();
+    grayTexture.clear();
+    thresholdTexture.clear();
+    texturesAllocated = false;
+}
+
+/*
+ * Returns a texture of the initial video data.  The textures are 
+ * uploaded from the core when asked for, so this must only be 
+ * called from the drawing thread while the channel is idle. 
+ * Images the core hasn't kept are left as they were.
+ */
+ofTexture* trackerChannel::getColorData() {
+    allocateTextures();
+    if (core.getColor().isAllocated()) colorTexture.loadData(core.getColor().getPixels(), core.width, core.height, GL_RGB);
+    return &colorTexture;
+}
+
+/*
+ * Returns a texture of a grascaled version of the video data.
+ */
+ofTexture* trackerChannel::getGrayscaleData() {
+    allocateTextures();
+    if (core.getGray().isAllocated()) grayTexture.loadData(core.getGray().getPixels(), core.width, core.height, GL_LUMINANCE);
+    return &grayTexture;
+}
+
+/*
+ * Returns a texture of the black/white data that represents 
+ * pixels that matched the settings.
+ */
+ofTexture* trackerChannel::getThresholdData() {
+    allocateTextures();
+    thresholdTexture.loadData(core.getMask().getPixels(), core.width, core.height, GL_LUMINANCE);
+    return &thresholdTexture;
+}
@@ -0,0 +1,93 @@
+/*
+ * trackerChannel.h
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  One frame source and the tracker core that 
+ * analyzes it.  Each channel can be processed on its own 
+ * thread, and its stages can overlap consecutive frames. 
+ * The position it finds is mapped into the area of the 
+ * screen the source covers.
+ *
+ */
+
+#ifndef _TRACKER_CHANNEL_H
+#define _TRACKER_CHANNEL_H
+
+#include "ofMain.h"
+#include "frameSource.h"
+#include "trackerCore.h"
+#include "stagedPipeline.h"
+#include "flightRecorder.h"
+#include "Poco/Semaphore.h"
+
+class tracker;
+
+/*
+ * Something a channel found, in screen pixels.
+ */
+struct trackerTarget {
+    ofPoint position;
+    float area;
+};
+
+class trackerChannel : public ofThread {
+
+    public:
+
+        trackerChannel(frameSource* _source, ofRectangle _area);
+        virtual ~trackerChannel();
+
+        bool setup(tracker* t, int _width, int _height);
+        void start();
+        void stop();
+
+        void setDebug(bool _debug);
+        void setStaged(bool _staged);
+        bool grab();
+        void process();
+        void submit();
+        void waitUntilProcessed();
+
+        bool hasTarget();
+        float getArea();
+        float getConfidence();
+        ofPoint getScreenPosition(int screenWidth, int screenHeight);
+        void getTargets(int screenWidth, int screenHeight, vector<trackerTarget>& targets);
+        trackerCore* getCore();
+        void benchmarkStages(stagedBenchmark* results);
+        flightRecorder* getRecorder();
+
+        ofTexture* getColorData();
+        ofTexture* getGrayscaleData();
+        ofTexture* getThresholdData();
+
+    private:
+
+        void threadedFunction();
+        void allocateTextures();
+        void releaseTextures();
+        void prepareStages();
+
+        tracker* owner;
+        frameSource* source;
+        screenMapping mapping;
+        Poco::Semaphore frameReady, frameDone;
+
+        trackerCore core;
+        trackerSettings settings;
+        bool debug;
+
+        stagedPipeline stages;
+        stagedResult result;
+        bool staged, stagesReady, usingStages;
+
+        flightRecorder recorder;
+
+        ofTexture colorTexture, grayTexture, thresholdTexture;
+        bool texturesAllocated;
+};
+
+#endif
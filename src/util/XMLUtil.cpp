@@ -89,7 +89,9 @@ void XMLUtil::saveCourse(string courseName, course* _course) {
 
 /*
  * Loads a course specified by the given name into the 
- * given course pointer.
+ * given course pointer.  Edges are matched to their nodes by 
+ * position, through a map built while the nodes are read; edges 
+ * whose nodes aren't in the file are skipped.
  */
 bool XMLUtil::loadCourse(string courseName, course* _course) {
     _course->clearCourse();
@@ -104,9 +106,13 @@ bool XMLUtil::loadCourse(string courseName, course* _course) {
 
     XML.pushTag("nodes", 0);
 
+    map<pair<int, int>, ofPoint*> nodesByPos;
     int numNodeTags = XML.getNumTags("node");
     for (int i = 0; i < numNodeTags; i++) {
-        _course->addNode(ofPoint(XML.getValue("node:x", 0, i), XML.getValue("node:y", 0, i)));
+        int x = XML.getValue("node:x", 0, i);
+        int y = XML.getValue("node:y", 0, i);
+        ofPoint* node = _course->addNode(ofPoint(x, y));
+        nodesByPos.insert(make_pair(make_pair(x, y), node));
     }
 
     //pop nodes
@@ -116,9 +122,10 @@ bool XMLUtil::loadCourse(string courseName, course* _course) {
     
     int numEdgeTags = XML.getNumTags("edge");
     for (int i = 0; i < numEdgeTags; i++) {
-        ofPoint p1 = ofPoint(XML.getValue("edge:p1:x", 0, i), XML.getValue("edge:p1:y", 0, i)); 
-        ofPoint p2 = ofPoint(XML.getValue("edge:p2:x", 0, i), XML.getValue("edge:p2:y", 0, i));
-        _course->addEdge(_course->getNodeWithPos(p1), _course->getNodeWithPos(p2));
+        map<pair<int, int>, ofPoint*>::iterator p1 = nodesByPos.find(make_pair(XML.getValue("edge:p1:x", 0, i), XML.getValue("edge:p1:y", 0, i)));
+        map<pair<int, int>, ofPoint*>::iterator p2 = nodesByPos.find(make_pair(XML.getValue("edge:p2:x", 0, i), XML.getValue("edge:p2:y", 0, i)));
+        if (p1 == nodesByPos.end() || p2 == nodesByPos.end()) continue;
+        _course->addEdge(p1->second, p2->second);
     }
 
     //pop edges
@@ -139,15 +146,25 @@ void XMLUtil::saveSettings(tracker* _tracker) {
     int tagNum = XML.addTag("configuration");
     XML.pushTag("configuration", tagNum);
 
+    trackerSettings settings = _tracker->getSettings();
+    string histogram = "";
+    if (settings.hasHistogram) {
+        for (int i = 0; i < HIST_BINS; i++) {
+            if (i > 0) histogram += ",";
+            histogram += ofToString((int)settings.histogram[i]);
+        }
+    }
+
     tagNum = XML.addTag("tracker");
-    XML.setValue("tracker:mode", _tracker->mode, tagNum);
-    XML.setValue("tracker:threshold", *_tracker->getThreshold(), tagNum);
-    XML.setValue("tracker:hue", *_tracker->getHue(), tagNum);
-    XML.setValue("tracker:saturation", *_tracker->getSaturation(), tagNum);
-    XML.setValue("tracker:value", *_tracker->getValue(), tagNum);
-    XML.setValue("tracker:hueRange", *_tracker->getHueRange(), tagNum);
-    XML.setValue("tracker:saturationRange", *_tracker->getSaturationRange(), tagNum);
-    XML.setValue("tracker:valueRange", *_tracker->getValueRange(), tagNum);
+    XML.setValue("tracker:mode", settings.mode, tagNum);
+    XML.setValue("tracker:threshold", settings.threshold, tagNum);
+    XML.setValue("tracker:hue", settings.hue, tagNum);
+    XML.setValue("tracker:saturation", settings.saturation, tagNum);
+    XML.setValue("tracker:value", settings.value, tagNum);
+    XML.setValue("tracker:hueRange", settings.hueRange, tagNum);
+    XML.setValue("tracker:saturationRange", settings.saturationRange, tagNum);
+    XML.setValue("tracker:valueRange", settings.valueRange, tagNum);
+    XML.setValue("tracker:histogram", histogram, tagNum);
 
     //pop configuration
     XML.popTag();
@@ -161,14 +178,184 @@ void XMLUtil::saveSettings(tracker* _tracker) {
 bool XMLUtil::loadSettings(tracker* _tracker) {
     if(!XML.loadFile("settings/configuration.xml")) return false;
 
-    _tracker->mode = XML.getValue("configuration:tracker:mode", LIGHT, 0);
-    _tracker->setThreshold(XML.getValue("configuration:tracker:threshold", 0, 0));
-    _tracker->setHue(XML.getValue("configuration:tracker:hue", 0, 0));
-    _tracker->setSaturation(XML.getValue("configuration:tracker:saturation", 0, 0));
-    _tracker->setValue(XML.getValue("configuration:tracker:value", 0, 0));
-    _tracker->setHueRange(XML.getValue("configuration:tracker:hueRange", 20, 0));
-    _tracker->setSaturationRange(XML.getValue("configuration:tracker:saturationRange", 30, 0));
-    _tracker->setValueRange(XML.getValue("configuration:tracker:valueRange", 25, 0));
+    trackerSettings settings;
+    settings.mode = XML.getValue("configuration:tracker:mode", LIGHT, 0);
+    settings.threshold = XML.getValue("configuration:tracker:threshold", 0, 0);
+    settings.hue = XML.getValue("configuration:tracker:hue", 0, 0);
+    settings.saturation = XML.getValue("configuration:tracker:saturation", 0, 0);
+    settings.value = XML.getValue("configuration:tracker:value", 0, 0);
+    settings.hueRange = XML.getValue("configuration:tracker:hueRange", 20, 0);
+    settings.saturationRange = XML.getValue("configuration:tracker:saturationRange", 30, 0);
+    settings.valueRange = XML.getValue("configuration:tracker:valueRange", 25, 0);
+
+    vector<string> bins = ofSplitString(XML.getValue("configuration:tracker:histogram", "", 0), ",");
+    if (bins.size() == HIST_BINS) {
+        for (int i = 0; i < HIST_BINS; i++) {
+            settings.histogram[i] = ofClamp(ofToInt(bins[i]), 0, 255);
+        }
+        settings.hasHistogram = true;
+    }
+    _tracker->setSettings(settings);
+
+    return true;
+}
+
+/*
+ * Loads the frame sources from sources.xml into the given 
+ * tracker pointer.  Each source is either a camera or a 
+ * recording replayed in its place, and covers a normalized 
+ * area of the screen.  A "staged" tag turns on running the 
+ * stages of each source on threads of their own.  Returns false 
+ * if there is no file, in which case the tracker uses the 
+ * default camera.
+ */
+bool XMLUtil::loadSources(tracker* _tracker) {
+    if(!XML.loadFile("settings/sources.xml")) return false;
+
+    XML.pushTag("sources", 0);
+
+    _tracker->setStaged(XML.getValue("staged", 0, 0) != 0);
+
+    int numSourceTags = XML.getNumTags("source");
+    for (int i = 0; i < numSourceTags; i++) {
+        ofRectangle area = ofRectangle(XML.getValue("source:x", 0.0, i), XML.getValue("source:y", 0.0, i),
+                                       XML.getValue("source:width", 1.0, i), XML.getValue("source:height", 1.0, i));
+        if (XML.getValue("source:type", "camera", i) == "recording") {
+            _tracker->addSource(new recordingSource(XML.getValue("source:file", "", i)), area);
+        }
+        else {
+            _tracker->addSource(new cameraSource(XML.getValue("source:device", 0, i)), area);
+        }
+    }
+
+    //pop sources
+    XML.popTag();
+    return true;
+}
+
+/*
+ * Loads where to publish the tracker's samples from 
+ * publishing.xml into the given tracker pointer.  A capacity 
+ * below one slot falls back to the default.  Returns false if 
+ * there is no file, in which case nothing is published.
+ */
+bool XMLUtil::loadPublishing(tracker* _tracker) {
+    if(!XML.loadFile("settings/publishing.xml")) return false;
+
+    string name = XML.getValue("publishing:name", "/flashtrack", 0);
+    int capacity = XML.getValue("publishing:capacity", SAMPLE_RING_CAPACITY, 0);
+    if (capacity < 1) capacity = SAMPLE_RING_CAPACITY;
+    return _tracker->publish(name, capacity);
+}
+
+/*
+ * Loads how much the flight recorders keep from recording.xml 
+ * into the given tracker pointer.  The budget is in megabytes. 
+ * Returns false if there is no file, in which case the defaults 
+ * are kept.
+ */
+bool XMLUtil::loadRecording(tracker* _tracker) {
+    if(!XML.loadFile("settings/recording.xml")) return false;
+
+    double seconds = XML.getValue("recording:seconds", (double)RECORDER_SECONDS, 0);
+    int budget = XML.getValue("recording:budget", RECORDER_BUDGET / (1024 * 1024), 0);
+    _tracker->setRecording(seconds, budget * 1024 * 1024);
+    return true;
+}
+
+/*
+ * Loads how the tracker latches its position before drawing from 
+ * latching.xml into the given tracker pointer.  The lead is in 
+ * milliseconds.  Returns false if there is no file, in which case 
+ * the defaults are kept.
+ */
+bool XMLUtil::loadLatching(tracker* _tracker) {
+    if(!XML.loadFile("settings/latching.xml")) return false;
+
+    bool enabled = XML.getValue("latching:enabled", 1, 0) != 0;
+    bool extrapolate = XML.getValue("latching:extrapolate", 0, 0) != 0;
+    double maxLead = XML.getValue("latching:maxLead", LATCH_MAX_LEAD * 1000, 0);
+    _tracker->setLatching(enabled, extrapolate, maxLead / 1000);
+    return true;
+}
+
+/*
+ * Loads what the auto tuner works on from settings/tuning.xml. 
+ * That is the recording to use and the known positions of the 
+ * target in some of its frames, in tracker coordinates as seen 
+ * on the configuration screen.
+ */
+bool XMLUtil::loadTuning(string& recording, vector<tuningSample>& samples) {
+    if(!XML.loadFile("settings/tuning.xml")) return false;
+
+    XML.pushTag("tuning", 0);
+    recording = XML.getValue("recording", "", 0);
+
+    int numSampleTags = XML.getNumTags("sample");
+    for (int i = 0; i < numSampleTags; i++) {
+        tuningSample sample;
+        sample.frame = XML.getValue("sample:frame", 0, i);
+        sample.x = XML.getValue("sample:x", 0.0, i);
+        sample.y = XML.getValue("sample:y", 0.0, i);
+        samples.push_back(sample);
+    }
+
+    //pop tuning
+    XML.popTag();
+    return recording != "";
+}
+
+/*
+ * Loads the cases the game simulator plays from 
+ * settings/simulation.xml.  Each case names a course and either 
+ * a recorded run or a list of points, and can expect the run to 
+ * complete or to crash, optionally near a given position, or to 
+ * end the way the reference says it should.
+ */
+bool XMLUtil::loadSimulation(gameSimulator* simulator) {
+    if(!XML.loadFile("settings/simulation.xml")) return false;
+
+    XML.pushTag("simulation", 0);
+    int numCaseTags = XML.getNumTags("case");
+    for (int i = 0; i < numCaseTags; i++) {
+        simulationCase c;
+        c.course = XML.getValue("case:course", "", i);
+        c.trace = XML.getValue("case:trace", "", i);
+
+        string expect = XML.getValue("case:expect", "any", i);
+        if (expect == "complete") c.expect = SIM_EXPECT_COMPLETE;
+        else if (expect == "crash") c.expect = SIM_EXPECT_CRASH;
+        else if (expect == "reference") c.expect = SIM_EXPECT_REFERENCE;
+        else {c.expect = SIM_EXPECT_ANY;}
+
+        XML.pushTag("case", i);
+        c.checkCrash = XML.getNumTags("crash") > 0;
+        c.crash.x = XML.getValue("crash:x", 0.0, 0);
+        c.crash.y = XML.getValue("crash:y", 0.0, 0);
+        double tolerance = c.expect == SIM_EXPECT_REFERENCE ? SIM_REFERENCE_TOLERANCE : NODE_SIZE;
+        c.tolerance = XML.getValue("crash:tolerance", tolerance, 0);
+        int numPointTags = XML.getNumTags("point");
+        for (int j = 0; j < numPointTags; j++) {
+            c.points.push_back(ofPoint(XML.getValue("point:x", 0.0, j), XML.getValue("point:y", 0.0, j)));
+        }
+        //pop case
+        XML.popTag();
+
+        simulator->addCase(c);
+    }
+    //pop simulation
+    XML.popTag();
+    return true;
+}
+
+/*
+ * Loads how many players race from race.xml into the given 
+ * game pointer.  Returns false if there is no file, in which 
+ * case one player plays.
+ */
+bool XMLUtil::loadRace(game* _game) {
+    if(!XML.loadFile("settings/race.xml")) return false;
 
+    _game->setNumPlayers(XML.getValue("race:players", 1, 0));
     return true;
 }
@@ -16,6 +16,9 @@
 #include "ofxXmlSettings.h"
 #include "course.h"
 #include "tracker.h"
+#include "parameterTuner.h"
+#include "gameSimulator.h"
+#include "game.h"
 
 class XMLUtil {
 
@@ -26,6 +29,13 @@ class XMLUtil {
         bool loadCourse(string courseName, course* _course);
         void saveSettings(tracker* _tracker);
         bool loadSettings(tracker* _tracker);
+        bool loadSources(tracker* _tracker);
+        bool loadPublishing(tracker* _tracker);
+        bool loadRecording(tracker* _tracker);
+        bool loadLatching(tracker* _tracker);
+        bool loadTuning(string& recording, vector<tuningSample>& samples);
+        bool loadSimulation(gameSimulator* simulator);
+        bool loadRace(game* _game);
     
     private:
 
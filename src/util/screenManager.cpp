@@ -35,7 +35,7 @@ void screenManager::setup(tracker* t) {
     createApp.setup(_tracker, this);
     configApp.setup(_tracker, this);
 
-    mode = TITLE;
+    mode = nextMode = TITLE;
     fader.setFadeSeconds(1.3f);
     fader.setUnitColor(0.0f, 0.0f, 0.0f);
     transition = true;
@@ -115,7 +115,7 @@ void screenManager::keyPressed  (int key) {
                 createApp.keyPressed(key);
                 break;
             case CONFIG:
-                //configApp.keyPressed(key);
+                configApp.keyPressed(key);
                 break;
         }
     }
@@ -241,3 +241,31 @@ void screenManager::setMode(int newMode) {
     fader.setAlpha(0);
     fader.fadeIn();
 }
+
+/*
+ * Returns how much tracking is needed right now.  During a 
+ * transition the screen being faded to counts as well, so the 
+ * tracker is running by the time it shows up.
+ */
+int screenManager::getTrackingDemand() {
+    int demand = getTrackingDemand(mode);
+    if (transition) demand = max(demand, getTrackingDemand(nextMode));
+    return demand;
+}
+
+/*
+ * Returns how much tracking the given screen needs.
+ */
+int screenManager::getTrackingDemand(int screen) {
+    switch (screen) {
+        case TITLE:
+            return titleApp.getTrackingDemand();
+        case SELECT:
+            return selectApp.getTrackingDemand();
+        case CREATE:
+            return createApp.getTrackingDemand();
+        case CONFIG:
+            return configApp.getTrackingDemand();
+    }
+    return TRACK_NONE;
+}
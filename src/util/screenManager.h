@@ -42,9 +42,12 @@ class screenManager : public ofBaseApp {
         void mouseReleased(int x, int y, int button);
 
         void setMode(int newMode);
+        int getTrackingDemand();
    
     private:
 
+        int getTrackingDemand(int screen);
+
         tracker* _tracker;
         title titleApp;
         selection selectApp;
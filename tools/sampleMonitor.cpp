@@ -0,0 +1,44 @@
+/*
+ * sampleMonitor.cpp
+ *
+ * Author: agent
+ * Date: 10/19/26
+ * Project: Flash Track
+ *
+ * Description:  A small client for the samples Flash Track 
+ * publishes in shared memory.  Prints every sample as it comes 
+ * in, along with how many were lost.  Doesn't need 
+ * openFrameworks, build it with:
+ *
+ *   g++ -I../src/tracking/core sampleMonitor.cpp ../src/tracking/core/sampleRing.cpp -lrt -o sampleMonitor
+ *
+ * and run it as "sampleMonitor [name]" while the game is running.
+ *
+ */
+
+#include "sampleRing.h"
+#include <stdio.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "/flashtrack";
+
+    sampleRingReader reader;
+    if (!reader.open(name)) {
+        fprintf(stderr, "no samples published as %s\n", name);
+        return 1;
+    }
+
+    trackerSample sample;
+    while (true) {
+        if (reader.next(sample)) {
+            printf("%u %llu %s x %.1f y %.1f area %.0f confidence %.2f lost %u\n",
+                   sample.sequence, sample.timestamp, sample.found ? "found" : "none",
+                   sample.x, sample.y, sample.area, sample.confidence, reader.getLost());
+        }
+        else {
+            usleep(1000);
+        }
+    }
+    return 0;
+}